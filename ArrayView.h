@@ -0,0 +1,63 @@
+#pragma once
+#include "DynamicArray.h"
+#include <stdexcept>
+#include <type_traits>
+
+// Non-owning view of a contiguous range (a span): a pointer and a length, iterated with raw
+// pointers. ArrayView<const T> only reads. operator[] follows DYNAMIC_ARRAY_BOUNDS_CHECK.
+// The view is valid while the viewed array is neither resized nor destroyed.
+template <typename T>
+class ArrayView {
+private:
+    T* first;
+    int length;
+
+public:
+    using value_type = typename std::remove_const<T>::type;
+    using iterator = T*;
+
+    ArrayView() : first(nullptr), length(0) {}
+
+    ArrayView(T* first, int length) : first(first), length(length) {
+        if (length < 0)
+            throw std::invalid_argument("ArrayView: negative length");
+    }
+
+    ArrayView(DynamicArray<value_type>& array) : first(array.data()), length(array.GetLength()) {}
+
+    // only for views of const elements
+    ArrayView(const DynamicArray<value_type>& array) : first(array.data()), length(array.GetLength()) {}
+
+    int GetLength() const {
+        return length;
+    }
+
+    bool IsEmpty() const {
+        return length == 0;
+    }
+
+    T& operator[](int index) const {
+        if (DYNAMIC_ARRAY_BOUNDS_CHECK && (index < 0 || index >= length))
+            throw std::out_of_range("Index out of range");
+        return first[index];
+    }
+
+    T* begin() const {
+        return first;
+    }
+
+    T* end() const {
+        return first + length;
+    }
+
+    T* data() const {
+        return first;
+    }
+
+    // count elements starting at start; always checked
+    ArrayView Subview(int start, int count) const {
+        if (start < 0 || count < 0 || start + count > length)
+            throw std::out_of_range("Subview: range out of bounds");
+        return ArrayView(first + start, count);
+    }
+};
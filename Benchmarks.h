@@ -0,0 +1,589 @@
+#pragma once
+#include "ArrayView.h"
+#include "Centrality.h"
+#include "CompressedGraph.h"
+#include "CsrGraph.h"
+#include "DefaultHash.h"
+#include "Graph.h"
+#include "GraphViews.h"
+#include "MutationLog.h"
+#include "PageRank.h"
+#include "Parallel.h"
+#include "ParallelColoring.h"
+#include "ShortestPaths.h"
+#include "Triangles.h"
+#include "VertexOrdering.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Wall-clock milliseconds of one call of action
+template <typename Action>
+double MeasureMilliseconds(Action action)
+{
+    auto start = std::chrono::steady_clock::now();
+    action();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// Random graph for the benchmarks, generated with a fixed seed
+inline CsrGraph<int> MakeBenchmarkGraph(int nodeCount, int edgeCount, double minWeight, double maxWeight)
+{
+    std::srand(42);
+    Graph<int, double> graph;
+    graph.GenerateGraph(nodeCount, edgeCount, minWeight, maxWeight);
+    return CsrGraph<int>(graph);
+}
+
+inline void BenchmarkDeltaSteppingScaling(const CsrGraph<int>& graph)
+{
+    std::cout << "Delta-stepping SSSP, " << graph.GetNodeCount() << " vertices, "
+        << graph.GetEdgeCount() << " arcs:\n";
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (maxThreads < 1) maxThreads = 1;
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        SetThreadCount(threads);
+        double ms = MeasureMilliseconds([&graph]() { DeltaSteppingDistances(graph, 0); });
+        if (threads == 1) baseline = ms;
+        std::cout << "  threads=" << threads << "  " << ms << " ms  speedup=" << baseline / ms << "\n";
+    }
+    SetThreadCount(0);
+}
+
+// Road-like grid: every cell is linked to its right and lower neighbours with random weights in [1, maxWeight]
+template <typename WeightType>
+Graph<int, WeightType> MakeGridGraph(int width, int height, int maxWeight)
+{
+    std::srand(42);
+    Graph<int, WeightType> graph;
+    for (int i = 0; i < width * height; i++) {
+        graph.InsertVertex(i);
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int v = y * width + x;
+            if (x + 1 < width) graph.ConnectNodes(v, v + 1, static_cast<WeightType>(1 + std::rand() % maxWeight));
+            if (y + 1 < height) graph.ConnectNodes(v, v + width, static_cast<WeightType>(1 + std::rand() % maxWeight));
+        }
+    }
+    return graph;
+}
+
+// Integer weights: the O(V^2) general MinDistances against Dial's buckets, then a binary heap against Dial's buckets
+inline void BenchmarkIntegerShortestPaths()
+{
+    Graph<int, double> smallReal = MakeGridGraph<double>(100, 100, 100);
+    Graph<int, int> smallInt = MakeGridGraph<int>(100, 100, 100);
+    std::cout << "Integer-weight SSSP, 100x100 grid:\n";
+    std::cout << "  general MinDistances  " << MeasureMilliseconds([&smallReal]() { MinDistances(smallReal, 0); }) << " ms\n";
+    std::cout << "  Dial MinDistances     " << MeasureMilliseconds([&smallInt]() { MinDistances(smallInt, 0); }) << " ms\n";
+
+    CsrGraph<int, ExactWeights<int>> large(MakeGridGraph<int>(400, 400, 100));
+    std::cout << "Integer-weight SSSP, 400x400 grid:\n";
+    std::cout << "  binary heap Dijkstra  " << MeasureMilliseconds([&large]() { DijkstraDistances(large, 0); }) << " ms\n";
+    std::cout << "  Dial buckets          " << MeasureMilliseconds([&large]() { DialDistances(large, 0); }) << " ms\n";
+}
+
+// SSSP and coloring sweeps on a grid whose vertex ids are scrambled, before and after reordering
+inline void BenchmarkVertexReordering()
+{
+    const int side = 400;
+    const int count = side * side;
+    std::srand(42);
+    Graph<int, int> grid;
+    for (int i = 0; i < count; i++) {
+        grid.InsertVertex(static_cast<int>((static_cast<long long>(i) * 7919) % count));
+    }
+    for (int v = 0; v < count; v++) {
+        if (v % side + 1 < side) grid.ConnectNodes(v, v + 1, 1 + std::rand() % 100);
+        if (v + side < count) grid.ConnectNodes(v, v + side, 1 + std::rand() % 100);
+    }
+    CsrGraph<int, ExactWeights<int>> scrambled(grid);
+
+    std::cout << "Vertex reordering, " << side << "x" << side << " grid with scrambled ids:\n";
+    const char* names[] = { "scrambled", "degree", "reverse Cuthill-McKee", "breadth-first", "community" };
+    VertexOrder orders[] = { VertexOrder::Degree, VertexOrder::ReverseCuthillMcKee,
+        VertexOrder::BreadthFirst, VertexOrder::Community };
+    for (int i = 0; i < 5; i++) {
+        CsrGraph<int, ExactWeights<int>> graph = scrambled;
+        double orderMs = 0.0;
+        if (i > 0) {
+            orderMs = MeasureMilliseconds([&]() { graph = scrambled.Permute(ComputeVertexOrder(scrambled, orders[i - 1])); });
+        }
+        int source = graph.FindNodeIndex(0);
+        double ssspMs = MeasureMilliseconds([&]() { DijkstraDistances(graph, source); });
+        double coloringMs = MeasureMilliseconds([&]() { GraphColoring(graph); });
+        std::cout << "  " << names[i] << ": reorder " << orderMs << " ms, SSSP " << ssspMs
+            << " ms, coloring " << coloringMs << " ms\n";
+    }
+}
+
+// Size and traversal speed of the compressed rows against the CSR snapshot
+template <typename WeightPolicy>
+void BenchmarkCompressedGraph(const char* name, const CsrGraph<int, WeightPolicy>& graph)
+{
+    CompressedGraph<int, WeightPolicy> compressed(graph);
+    std::cout << "Compressed adjacency, " << name << ", " << graph.GetNodeCount() << " vertices, "
+        << graph.GetEdgeCount() << " arcs:\n";
+    std::cout << "  CSR " << graph.MemoryUsage() << " bytes, compressed " << compressed.MemoryUsage()
+        << " bytes, " << compressed.BitsPerEdge() << " bits per edge for the ids\n";
+    std::cout << "  BFS on CSR " << MeasureMilliseconds([&]() { BreadthFirstSearch(graph, 0); })
+        << " ms, on compressed " << MeasureMilliseconds([&]() { BreadthFirstSearch(compressed, 0); }) << " ms\n";
+    std::cout << "  SSSP on CSR " << MeasureMilliseconds([&]() { DijkstraDistances(graph, 0); })
+        << " ms, on compressed " << MeasureMilliseconds([&]() { DijkstraDistances(compressed, 0); }) << " ms\n";
+}
+
+// Persisting mutations through the log against rewriting the whole graph with SaveToFile
+inline void BenchmarkMutationLog()
+{
+    std::srand(42);
+    Graph<int, double> graph;
+    graph.GenerateGraph(20000, 100000, 1.0, 100.0);
+    std::remove("benchmark_wal.log");
+    std::remove("benchmark_wal.snapshot");
+    const int mutations = 10000;
+    double logMs = 0.0, saveMs = 0.0;
+    {
+        MutationLog<int, double> log(graph, "benchmark_wal");
+        logMs = MeasureMilliseconds([&]() {
+            for (int i = 0; i < mutations; i++) {
+                log.ConnectNodes(std::rand() % 20000, std::rand() % 20000, 1.0 + std::rand() % 100);
+            }
+            log.Commit();
+        });
+        saveMs = MeasureMilliseconds([&]() { log.Checkpoint(); });
+    }
+    std::remove("benchmark_wal.log");
+    std::remove("benchmark_wal.snapshot");
+    std::cout << "Mutation log, " << graph.GetNodeCount() << " vertices:\n";
+    std::cout << "  " << mutations << " logged mutations " << logMs << " ms (" << 1000.0 * logMs / mutations
+        << " us each), one full snapshot " << saveMs << " ms\n";
+}
+
+// Cost of a copy-on-write snapshot and of the first mutations made on it
+inline void BenchmarkSnapshots()
+{
+    std::srand(42);
+    Graph<int, double> graph;
+    graph.GenerateGraph(100000, 1000000, 1.0, 100.0);
+    Graph<int, double> snapshot;
+    double snapshotMs = MeasureMilliseconds([&]() { snapshot = graph.Snapshot(); });
+    const int mutations = 1000;
+    double mutateMs = MeasureMilliseconds([&]() {
+        for (int i = 0; i < mutations; i++) {
+            snapshot.ConnectNodes(std::rand() % 100000, std::rand() % 100000, 1.0);
+        }
+    });
+    std::cout << "Copy-on-write snapshots, " << graph.GetNodeCount() << " vertices:\n";
+    std::cout << "  snapshot " << snapshotMs << " ms, " << mutations << " mutations on it " << mutateMs << " ms\n";
+}
+
+// One batch of edge insertions and removals against the same operations applied one by one
+inline void BenchmarkBatchMutations()
+{
+    // two independent graphs, a copy would share its storage and pay for copy-on-write
+    Graph<int, double> graph, sequential;
+    std::srand(42);
+    graph.GenerateGraph(100000, 1000000, 1.0, 100.0);
+    std::srand(42);
+    sequential.GenerateGraph(100000, 1000000, 1.0, 100.0);
+    DynamicArray<EdgeOperation<int, double>> ops;
+    for (int i = 0; i < 100000; i++) {
+        int a = std::rand() % 100000, b = std::rand() % 100000;
+        if (i % 4 == 0) ops.Append(EdgeOperation<int, double>::Disconnect(a, b));
+        else ops.Append(EdgeOperation<int, double>::Connect(a, b, 1.0));
+    }
+    double sequentialMs = MeasureMilliseconds([&]() {
+        for (int i = 0; i < ops.GetLength(); i++) {
+            if (ops[i].type == EdgeOperationType::Connect) sequential.ConnectNodes(ops[i].from, ops[i].to, ops[i].weight);
+            else sequential.DisconnectNodes(ops[i].from, ops[i].to);
+        }
+    });
+    double batchMs = MeasureMilliseconds([&]() { graph.ApplyBatch(ops); });
+    std::cout << "Batch of " << ops.GetLength() << " edge operations:\n";
+    std::cout << "  one by one " << sequentialMs << " ms, ApplyBatch " << batchMs << " ms\n";
+}
+
+// Shortest paths on half of the vertices and the light edges: a view against a rebuilt graph
+inline void BenchmarkGraphViews()
+{
+    std::srand(42);
+    Graph<int, int> graph;
+    graph.GenerateGraph(100000, 1000000, 1, 100);
+    CsrGraph<int, ExactWeights<int>> csr(graph);
+    DynamicArray<bool> mask;
+    for (int v = 0; v < csr.GetNodeCount(); v++) mask.Append(v % 2 == 0);
+    auto light = [](int, int, int w) { return w <= 50; };
+
+    long long reached = 0;
+    double viewMs = MeasureMilliseconds([&]() {
+        auto paths = MinDistances(FilterEdges(MaskVertices(csr, mask), light), 0);
+        for (int v = 0; v < paths.GetLength(); v++) reached += paths[v].distance != -1;
+    });
+    double rebuildMs = MeasureMilliseconds([&]() {
+        Graph<int, int> subgraph;
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            if (mask[v]) subgraph.InsertVertex(csr.GetVertex(v));
+        }
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                if (mask[v] && mask[csr.GetTarget(e)] && light(v, csr.GetTarget(e), csr.GetWeight(e)))
+                    subgraph.ConnectNodes(csr.GetVertex(v), csr.GetVertex(csr.GetTarget(e)), csr.GetWeight(e));
+            }
+        }
+        auto paths = MinDistances(subgraph, 0);
+        for (int v = 0; v < paths.GetLength(); v++) reached -= paths[v].distance != -1;
+    });
+    std::cout << "Shortest paths on a filtered half of " << csr.GetNodeCount() << " vertices:\n";
+    std::cout << "  view " << viewMs << " ms, rebuilt graph " << rebuildMs << " ms"
+              << (reached == 0 ? "" : " (results differ)") << "\n";
+}
+
+// Summing an array through the Sequence interface, its iterators, operator[] and raw pointers
+inline void BenchmarkArrayIteration()
+{
+    const int size = 10000000;
+    DynamicArray<int> values(size);
+    for (int i = 0; i < size; i++) values.Append(i & 1023);
+    Sequence<int>& sequence = values;
+    long long sums[4] = { 0, 0, 0, 0 };
+
+    double virtualMs = MeasureMilliseconds([&]() {
+        for (int i = 0; i < sequence.GetLength(); i++) sums[0] += sequence.GetElem(i);
+    });
+    double iteratorMs = MeasureMilliseconds([&]() {
+        Sequence<int>::Iterator* it = sequence.ToBegin();
+        Sequence<int>::Iterator* end = sequence.ToEnd();
+        for (; *it != *end; ++(*it)) sums[1] += **it;
+        delete it;
+        delete end;
+    });
+    double indexMs = MeasureMilliseconds([&]() {
+        for (int i = 0; i < values.GetLength(); i++) sums[2] += values[i];
+    });
+    double pointerMs = MeasureMilliseconds([&]() {
+        for (int v : ArrayView<const int>(values)) sums[3] += v;
+    });
+    std::cout << "Summing " << size << " ints (bounds checks " << (DYNAMIC_ARRAY_BOUNDS_CHECK ? "on" : "off") << "):\n";
+    std::cout << "  Sequence::GetElem " << virtualMs << " ms, Sequence iterators " << iteratorMs
+              << " ms, operator[] " << indexMs << " ms, range-for " << pointerMs << " ms"
+              << (sums[0] == sums[3] && sums[1] == sums[3] && sums[2] == sums[3] ? "" : " (sums differ)") << "\n";
+}
+
+struct ProbeStatistics {
+    double mean;
+    int longest;
+};
+
+// Inserts the (distinct) keys into a linear-probing table of a power-of-two size, at least twice
+// the key count, indexed by the low bits of the hash; probes per insertion
+template <typename Key, typename Hasher>
+ProbeStatistics MeasureProbes(const DynamicArray<Key>& keys, Hasher hasher)
+{
+    size_t capacity = 1;
+    while (capacity < 2 * static_cast<size_t>(keys.GetLength())) capacity <<= 1;
+    DynamicArray<bool> used(static_cast<int>(capacity));
+    for (size_t i = 0; i < capacity; i++) used.Append(false);
+    long long total = 0;
+    int longest = 0;
+    for (const Key& key : keys) {
+        size_t slot = hasher(key) & (capacity - 1);
+        int probes = 1;
+        while (used[static_cast<int>(slot)]) {
+            slot = (slot + 1) & (capacity - 1);
+            probes++;
+        }
+        used[static_cast<int>(slot)] = true;
+        total += probes;
+        if (probes > longest) longest = probes;
+    }
+    return ProbeStatistics{ keys.GetLength() > 0 ? static_cast<double>(total) / keys.GetLength() : 0.0, longest };
+}
+
+template <typename Key, typename Hasher>
+void ReportProbes(const char* name, const DynamicArray<Key>& keys, Hasher hasher)
+{
+    ProbeStatistics stats = MeasureProbes(keys, hasher);
+    std::cout << " " << name << " " << stats.mean << " / " << stats.longest;
+}
+
+// Hash throughput, and probe lengths in a power-of-two table for the key sets of the graphs:
+// std::hash with the old pair combination h1 ^ (h2 << 1), DefaultHash and MixedHash
+inline void BenchmarkHashing()
+{
+    const int keyCount = 1 << 16;
+    DynamicArray<int> sequential, strided;
+    DynamicArray<std::string> names;
+    DynamicArray<Pair<int, int>> pairs;
+    for (int i = 0; i < keyCount; i++) {
+        sequential.Append(i);
+        strided.Append(i * 1024);
+        names.Append("Node" + std::to_string(i));
+        pairs.Append(Pair<int, int>(i / 256, i % 256));
+    }
+    auto oldPairHash = [](const Pair<int, int>& p) {
+        return std::hash<int>()(p.key) ^ (std::hash<int>()(p.value) << 1);
+    };
+
+    std::cout << "Probe lengths (mean / longest), linear probing in a power-of-two table:\n";
+    std::cout << "  sequential ints:";
+    ReportProbes("std::hash", sequential, std::hash<int>());
+    ReportProbes("DefaultHash", sequential, DefaultHash<int>());
+    ReportProbes("MixedHash", sequential, MixedHash<int>());
+    std::cout << "\n  ints with stride 1024:";
+    ReportProbes("std::hash", strided, std::hash<int>());
+    ReportProbes("DefaultHash", strided, DefaultHash<int>());
+    ReportProbes("MixedHash", strided, MixedHash<int>());
+    std::cout << "\n  NodeN strings:";
+    ReportProbes("std::hash", names, std::hash<std::string>());
+    ReportProbes("DefaultHash", names, DefaultHash<std::string>());
+    std::cout << "\n  int pairs of a 256 x 256 grid:";
+    ReportProbes("old combination", pairs, oldPairHash);
+    ReportProbes("DefaultHash", pairs, DefaultHash<Pair<int, int>>());
+    std::cout << "\n";
+
+    const int rounds = 2000000;
+    uint64_t sink = 0;
+    double mixMs = MeasureMilliseconds([&]() {
+        for (int i = 0; i < rounds; i++) sink += MixHash(static_cast<uint64_t>(i));
+    });
+    std::cout << "Throughput: MixHash " << rounds / mixMs / 1000.0 << " M keys/s";
+    const int lengths[3] = { 8, 64, 1024 };
+    for (int length : lengths) {
+        std::string key(length, 'x');
+        for (int i = 0; i < length; i++) key[i] = static_cast<char>('a' + (i * 7) % 26);
+        int count = rounds * 8 / length;
+        double ownMs = MeasureMilliseconds([&]() {
+            for (int i = 0; i < count; i++) {
+                key[0] = static_cast<char>(i);
+                sink += HashBytes(key.data(), key.size());
+            }
+        });
+        double stdMs = MeasureMilliseconds([&]() {
+            for (int i = 0; i < count; i++) {
+                key[0] = static_cast<char>(i);
+                sink += std::hash<std::string>()(key);
+            }
+        });
+        double megabytes = static_cast<double>(count) * length / 1e6;
+        std::cout << ", " << length << "-byte strings HashBytes " << megabytes / ownMs << " GB/s (std::hash "
+                  << megabytes / stdMs << ")";
+    }
+    std::cout << (sink == 42 ? " " : "") << "\n";
+}
+
+// Triangle counting on a dense random graph, and the intersection kernels on their own
+inline void BenchmarkTriangles()
+{
+    CsrGraph<int> graph = MakeBenchmarkGraph(20000, 1000000, 1.0, 2.0);
+    for (int threads : { 1, 0 }) {
+        SetThreadCount(threads);
+        long long total = 0;
+        double ms = MeasureMilliseconds([&]() { total = CountTriangles(graph).totalTriangles; });
+        std::cout << "Triangles of 20000 vertices / 1M edges, " << GetThreadCount() << " threads: " << total
+                  << " in " << ms << " ms\n";
+    }
+    SetThreadCount(0);
+
+    // random sorted lists, so that the merge cannot predict its branches
+    DynamicArray<int> a, b;
+    std::srand(7);
+    for (int i = 0, x = 0, y = 0; i < 4096; i++) {
+        a.Append(x += 1 + std::rand() % 4);
+        b.Append(y += 1 + std::rand() % 4);
+    }
+    const int rounds = 2000;
+    long long scalarSum = 0, blockSum = 0;
+    double scalarMs = MeasureMilliseconds([&]() {
+        for (int r = 0; r < rounds; r++) {
+            TriangleDetail::IntersectScalar(a.data(), a.GetLength(), b.data(), b.GetLength(), [&](int x) { scalarSum += x; });
+        }
+    });
+    double blockMs = MeasureMilliseconds([&]() {
+        for (int r = 0; r < rounds; r++) {
+            TriangleDetail::IntersectBlocks(a.data(), a.GetLength(), b.data(), b.GetLength(), [&](int x) { blockSum += x; });
+        }
+    });
+    std::cout << "  intersecting two 4096-element lists: merge " << scalarMs * 1000.0 / rounds << " us, blocks "
+              << blockMs * 1000.0 / rounds << " us" << (scalarSum == blockSum ? "" : " (results differ)") << "\n";
+}
+
+// Greedy coloring in id order against Jones-Plassmann rounds on the pool
+inline void BenchmarkColoring(const CsrGraph<int>& graph)
+{
+    int greedyColors = 0;
+    double greedyMs = MeasureMilliseconds([&]() {
+        DynamicArray<int> colors = GraphColoring(graph);
+        for (int v = 0; v < colors.GetLength(); v++) {
+            if (colors[v] >= greedyColors) greedyColors = colors[v] + 1;
+        }
+    });
+    std::cout << "Coloring, " << graph.GetNodeCount() << " vertices, " << graph.GetEdgeCount() << " arcs: greedy "
+              << greedyMs << " ms, " << greedyColors << " colors\n";
+    for (int threads : { 1, 0 }) {
+        SetThreadCount(threads);
+        int parallelColors = 0;
+        double ms = MeasureMilliseconds([&]() {
+            DynamicArray<int> colors = ParallelGraphColoring(graph);
+            for (int v = 0; v < colors.GetLength(); v++) {
+                if (colors[v] >= parallelColors) parallelColors = colors[v] + 1;
+            }
+        });
+        std::cout << "  Jones-Plassmann, " << GetThreadCount() << " threads: " << ms << " ms, " << parallelColors
+                  << " colors\n";
+    }
+    SetThreadCount(0);
+}
+
+inline void BenchmarkBetweenness()
+{
+    for (double maxWeight : { 1.0, 100.0 }) {
+        CsrGraph<int> graph = MakeBenchmarkGraph(2000, 10000, 1.0, maxWeight);
+        const char* search = maxWeight == 1.0 ? "BFS" : "Dijkstra";
+        DynamicArray<double> exact;
+        for (int threads : { 1, 0 }) {
+            SetThreadCount(threads);
+            double ms = MeasureMilliseconds([&]() { exact = BetweennessCentrality(graph); });
+            std::cout << "Betweenness of 2000 vertices / 10000 edges (" << search << "), " << GetThreadCount()
+                      << " threads: " << ms << " ms\n";
+        }
+        SetThreadCount(0);
+
+        // the worst error over all vertices, as a fraction of the number of pairs
+        DynamicArray<double> estimate;
+        double ms = MeasureMilliseconds([&]() { estimate = ApproximateBetweenness(graph, 0.1, 0.1); });
+        double pairs = 2000.0 * 1998.0 / 2.0, worst = 0.0;
+        for (int v = 0; v < 2000; v++) {
+            double error = (estimate[v] > exact[v] ? estimate[v] - exact[v] : exact[v] - estimate[v]) / pairs;
+            if (error > worst) worst = error;
+        }
+        std::cout << "  sampled with epsilon 0.1 (" << BetweennessSampleCount(2000, 0.1, 0.1) << " sources): " << ms
+                  << " ms, worst normalized error " << worst << "\n";
+    }
+
+    CsrGraph<int> large = MakeBenchmarkGraph(20000, 100000, 1.0, 1.0);
+    double ms = MeasureMilliseconds([&]() { ApproximateBetweenness(large, 0.1, 0.1); });
+    std::cout << "Sampled betweenness of 20000 vertices / 100000 edges (" << BetweennessSampleCount(20000, 0.1, 0.1)
+              << " sources): " << ms << " ms\n";
+}
+
+// One PageRank iteration through the Graph API: a copied edge list and an index lookup per edge
+inline double NaivePageRankIteration(const Graph<int, double, Directed>& graph, const DynamicArray<double>& outWeight,
+    const DynamicArray<double>& rank, DynamicArray<double>& next)
+{
+    int numNodes = graph.GetNodeCount();
+    double dangling = 0.0;
+    for (int u = 0; u < numNodes; u++) {
+        next[u] = 0.0;
+        if (outWeight[u] == 0.0) dangling += rank[u];
+    }
+    for (int u = 0; u < numNodes; u++) {
+        auto edges = graph.GetAdjacentVertices(graph.GetVertex(u));
+        for (int e = 0; e < edges.GetLength(); e++) {
+            next[graph.FindNodeIndex(edges[e].GetNode())] += rank[u] * edges[e].GetWeight() / outWeight[u];
+        }
+    }
+    double residual = 0.0;
+    for (int v = 0; v < numNodes; v++) {
+        next[v] = 0.85 * (next[v] + dangling / numNodes) + 0.15 / numNodes;
+        residual += std::fabs(next[v] - rank[v]);
+    }
+    return residual;
+}
+
+inline void BenchmarkPageRank()
+{
+    std::srand(42);
+    Graph<int, double, Directed> graph;
+    graph.GenerateGraph(100000, 1000000, 1.0, 10.0);
+    CsrGraph<int> csr(graph);
+
+    DynamicArray<double> outWeight, rank, next;
+    for (int u = 0; u < graph.GetNodeCount(); u++) {
+        double sum = 0.0;
+        csr.ForEachNeighbor(u, [&](int, double w) { sum += w; });
+        outWeight.Append(sum);
+        rank.Append(1.0 / graph.GetNodeCount());
+        next.Append(0.0);
+    }
+    double naiveMs = MeasureMilliseconds([&]() { NaivePageRankIteration(graph, outWeight, rank, next); });
+    std::cout << "PageRank of 100000 vertices / 1M directed edges, one iteration through the Graph API: "
+              << naiveMs << " ms\n";
+
+    for (PropagationMode mode : { PropagationMode::Pull, PropagationMode::Push }) {
+        for (int threads : { 1, 0 }) {
+            SetThreadCount(threads);
+            PageRankResult result;
+            double ms = MeasureMilliseconds([&]() { result = PageRank(csr, 0.85, 1e-9, 100, mode); });
+            std::cout << "  " << (mode == PropagationMode::Pull ? "pull" : "push") << ", " << GetThreadCount()
+                      << " threads: " << result.iterations << " iterations in " << ms << " ms ("
+                      << ms / result.iterations << " ms per iteration, setup included)\n";
+        }
+    }
+    SetThreadCount(0);
+}
+
+// Cost of starting a parallel loop: the shared pool against starting threads for every loop
+inline void BenchmarkThreadPool()
+{
+    const int loops = 2000;
+    DynamicArray<int> data;
+    for (int i = 0; i < 4096; i++) data.Append(i);
+    SetThreadCount(4);
+    long long poolSum = 0, spawnSum = 0;
+    double poolMs = MeasureMilliseconds([&]() {
+        for (int l = 0; l < loops; l++) {
+            poolSum += ParallelReduce(0, data.GetLength(), 0LL, [&](int i) { return static_cast<long long>(data[i]); },
+                [](long long a, long long b) { return a + b; });
+        }
+    });
+    double spawnMs = MeasureMilliseconds([&]() {
+        for (int l = 0; l < loops; l++) {
+            long long partial[4] = { 0, 0, 0, 0 };
+            auto block = [&](int worker) {
+                for (int i = worker * 1024; i < (worker + 1) * 1024; i++) partial[worker] += data[i];
+            };
+            std::thread* threads[3];
+            for (int t = 1; t < 4; t++) threads[t - 1] = new std::thread(block, t);
+            block(0);
+            for (int t = 0; t < 3; t++) {
+                threads[t]->join();
+                delete threads[t];
+            }
+            spawnSum += partial[0] + partial[1] + partial[2] + partial[3];
+        }
+    });
+    SetThreadCount(0);
+    std::cout << "Parallel loop of 4096 elements on 4 threads: pool " << poolMs * 1000.0 / loops
+              << " us, new threads per loop " << spawnMs * 1000.0 / loops << " us"
+              << (poolSum == spawnSum ? "" : " (results differ)") << "\n";
+}
+
+inline void RunAllBenchmarks()
+{
+    std::cout << "\nRunning benchmarks...\n";
+    CsrGraph<int> graph = MakeBenchmarkGraph(100000, 1000000, 1.0, 100.0);
+    BenchmarkDeltaSteppingScaling(graph);
+    BenchmarkCompressedGraph("random graph", graph);
+    BenchmarkCompressedGraph("random graph in breadth-first order", graph.Permute(BreadthFirstOrder(graph)));
+    BenchmarkIntegerShortestPaths();
+    BenchmarkVertexReordering();
+    BenchmarkMutationLog();
+    BenchmarkSnapshots();
+    BenchmarkBatchMutations();
+    BenchmarkGraphViews();
+    BenchmarkArrayIteration();
+    BenchmarkHashing();
+    BenchmarkTriangles();
+    BenchmarkColoring(graph);
+    BenchmarkBetweenness();
+    BenchmarkPageRank();
+    BenchmarkThreadPool();
+    std::cout << "Benchmarks finished.\n\n";
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "DynamicArray.h"
+#include <stdexcept>
+
+// Min-heap over DynamicArray; elements are compared with operator<
+template <typename T>
+class BinaryHeap {
+private:
+    DynamicArray<T> items;
+
+    void SiftUp(int index) {
+        while (index > 0) {
+            int parent = (index - 1) / 2;
+            if (!(items[index] < items[parent]))
+                break;
+            items.Swap(items[index], items[parent]);
+            index = parent;
+        }
+    }
+
+    void SiftDown(int index) {
+        int size = items.GetLength();
+        while (true) {
+            int smallest = index;
+            int left = 2 * index + 1;
+            int right = left + 1;
+            if (left < size && items[left] < items[smallest]) smallest = left;
+            if (right < size && items[right] < items[smallest]) smallest = right;
+            if (smallest == index)
+                break;
+            items.Swap(items[index], items[smallest]);
+            index = smallest;
+        }
+    }
+
+public:
+    BinaryHeap() : items() {}
+
+    void Push(const T& item) {
+        items.Append(item);
+        SiftUp(items.GetLength() - 1);
+    }
+
+    const T& Top() const {
+        if (items.GetLength() == 0) throw std::out_of_range("Heap is empty");
+        return items[0];
+    }
+
+    T Pop() {
+        if (items.GetLength() == 0) throw std::out_of_range("Heap is empty");
+        T top = items[0];
+        int last = items.GetLength() - 1;
+        items[0] = items[last];
+        items.Truncate(last);
+        if (last > 0) SiftDown(0);
+        return top;
+    }
+
+    bool IsEmpty() const {
+        return items.GetLength() == 0;
+    }
+
+    int GetLength() const {
+        return items.GetLength();
+    }
+
+    void Clear() {
+        items.Truncate(0);
+    }
+};
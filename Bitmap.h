@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// Fixed-size bit set whose bits can be set concurrently from several threads
+class Bitmap {
+private:
+    std::atomic<uint64_t>* words;
+    int wordCount;
+    int size;
+
+public:
+    explicit Bitmap(int size = 0) : wordCount((size + 63) / 64), size(size) {
+        if (size < 0) throw std::out_of_range("Bitmap size is negative");
+        words = new std::atomic<uint64_t>[wordCount > 0 ? wordCount : 1];
+        Clear();
+    }
+
+    Bitmap(const Bitmap& other) : wordCount(other.wordCount), size(other.size) {
+        words = new std::atomic<uint64_t>[wordCount > 0 ? wordCount : 1];
+        for (int i = 0; i < wordCount; i++) {
+            words[i].store(other.words[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    Bitmap& operator=(const Bitmap& other) {
+        if (this == &other) {
+            return *this;
+        }
+        Bitmap copy(other);
+        Swap(copy);
+        return *this;
+    }
+
+    ~Bitmap() {
+        delete[] words;
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    bool Get(int index) const {
+        return (words[index >> 6].load(std::memory_order_relaxed) >> (index & 63)) & 1u;
+    }
+
+    void Set(int index) {
+        words[index >> 6].fetch_or(uint64_t(1) << (index & 63), std::memory_order_relaxed);
+    }
+
+    // Sets the bit and reports whether it was already set
+    bool TestAndSet(int index) {
+        uint64_t mask = uint64_t(1) << (index & 63);
+        if (words[index >> 6].load(std::memory_order_relaxed) & mask)
+            return true;
+        return (words[index >> 6].fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+    }
+
+    void Clear() {
+        for (int i = 0; i < wordCount; i++) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int Count() const {
+        int count = 0;
+        for (int i = 0; i < wordCount; i++) {
+            uint64_t w = words[i].load(std::memory_order_relaxed);
+            while (w) {
+                w &= w - 1;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void Swap(Bitmap& other) {
+        std::atomic<uint64_t>* tempWords = words;
+        words = other.words;
+        other.words = tempWords;
+        int temp = wordCount;
+        wordCount = other.wordCount;
+        other.wordCount = temp;
+        temp = size;
+        size = other.size;
+        other.size = temp;
+    }
+};
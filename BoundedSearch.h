@@ -0,0 +1,125 @@
+#pragma once
+#include "BinaryHeap.h"
+#include "CsrGraph.h"
+#include "Pair.h"
+#include <climits>
+
+struct NearVertex {
+    int vertex;
+    int distance;
+};
+
+// Dijkstra that stops early: all vertices within a radius, or the k closest vertices of a source.
+// The per-vertex scratch is allocated once and validated by a query stamp instead of being
+// cleared, so a query costs time proportional to the region it explores, not to V.
+// Distances are truncated to int as in MinDistances.
+template <typename TKey, typename WeightPolicy>
+class BoundedSearch {
+private:
+    const CsrGraph<TKey, WeightPolicy>& graph;
+    // distance[v] and parent[v] belong to the current query only if stamp[v] == query;
+    // settledStamp[v] == query marks the vertices the query returned
+    DynamicArray<unsigned int> stamp;
+    DynamicArray<unsigned int> settledStamp;
+    DynamicArray<int> distance;
+    DynamicArray<int> parent;
+    unsigned int query;
+    BinaryHeap<Pair<int, int>> heap;
+    DynamicArray<NearVertex> settled;
+
+    bool IsReached(int v) const {
+        return stamp[v] == query;
+    }
+
+    void StartQuery() {
+        if (++query == 0) {
+            // the counter wrapped around: old stamps could look current again
+            for (int v = 0; v < stamp.GetLength(); v++) {
+                stamp[v] = 0;
+                settledStamp[v] = 0;
+            }
+            query = 1;
+        }
+        heap.Clear();
+        settled.Truncate(0);
+    }
+
+    // Settles vertices in order of distance until one is farther than radius or count are settled
+    void Run(int source, int radius, int count) {
+        StartQuery();
+        if (source < 0 || source >= graph.GetNodeCount() || radius < 0 || count <= 0)
+            return;
+
+        stamp[source] = query;
+        distance[source] = 0;
+        parent[source] = -1;
+        heap.Push(Pair<int, int>(0, source));
+        while (!heap.IsEmpty() && settled.GetLength() < count) {
+            Pair<int, int> top = heap.Pop();
+            int u = top.value;
+            if (top.key != distance[u])
+                continue;
+            settledStamp[u] = query;
+            settled.Append({ u, top.key });
+            for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                int v = graph.GetTarget(e);
+                int newDist = top.key + static_cast<int>(graph.GetWeight(e));
+                if (newDist > radius)
+                    continue;
+                if (!IsReached(v) || newDist < distance[v]) {
+                    stamp[v] = query;
+                    distance[v] = newDist;
+                    parent[v] = u;
+                    heap.Push(Pair<int, int>(newDist, v));
+                }
+            }
+        }
+    }
+
+public:
+    explicit BoundedSearch(const CsrGraph<TKey, WeightPolicy>& graph)
+        : graph(graph), stamp(graph.GetNodeCount()), settledStamp(graph.GetNodeCount()),
+          distance(graph.GetNodeCount()), parent(graph.GetNodeCount()), query(0), heap(), settled() {
+        for (int v = 0; v < graph.GetNodeCount(); v++) {
+            stamp.Append(0);
+            settledStamp.Append(0);
+            distance.Append(0);
+            parent.Append(-1);
+        }
+    }
+
+    // Vertices at distance <= radius from source, closest first.
+    // The returned array is reused by the next query.
+    const DynamicArray<NearVertex>& WithinRadius(int source, int radius) {
+        Run(source, radius, INT_MAX);
+        return settled;
+    }
+
+    // The k vertices closest to source (the source included), closest first; fewer if less are reachable.
+    // The returned array is reused by the next query.
+    const DynamicArray<NearVertex>& Nearest(int source, int k) {
+        Run(source, INT_MAX, k);
+        return settled;
+    }
+
+    // Distance of a vertex returned by the last query, -1 for any other vertex
+    int GetDistance(int v) const {
+        return query != 0 && settledStamp[v] == query ? distance[v] : -1;
+    }
+
+    // Shortest path from the source of the last query to a vertex it returned, empty otherwise
+    DynamicArray<TKey> GetPath(int v) const {
+        DynamicArray<TKey> path;
+        if (GetDistance(v) == -1)
+            return path;
+        for (int u = v; u != -1; u = parent[u]) {
+            path.Append(graph.GetVertex(u));
+        }
+        for (int i = 0, j = path.GetLength() - 1; i < j; i++, j--) {
+            TKey temp = path[i];
+            path[i] = path[j];
+            path[j] = temp;
+        }
+        return path;
+    }
+};
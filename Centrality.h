@@ -0,0 +1,268 @@
+#pragma once
+#include "BinaryHeap.h"
+#include "CsrGraph.h"
+#include "Graph.h"
+#include "Pair.h"
+#include "Parallel.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+// Betweenness centrality with Brandes' algorithm: one shortest-path search per source counts the
+// shortest paths sigma, then dependencies are accumulated in order of decreasing distance.
+// Graphs whose edges all have the same positive weight are searched with BFS, others with Dijkstra
+// (weights must be positive). Sources are split between threads, each with its own accumulator.
+// Values are pair counts: in an undirected graph every unordered pair {s, t} counts once.
+
+namespace BetweennessDetail {
+
+    // Scratch space of one worker, reused for all of its sources; empty until the worker's first
+    // source, so that workers without sources allocate nothing
+    struct SearchState {
+        DynamicArray<double> distance;
+        DynamicArray<double> sigma;
+        // dependency, then the share passed on per path during accumulation
+        DynamicArray<double> dependency;
+        // vertices in the order they were settled, so in order of non-decreasing distance
+        DynamicArray<int> order;
+        BinaryHeap<Pair<double, int>> heap;
+
+        void Prepare(int numNodes) {
+            if (distance.GetLength() == numNodes)
+                return;
+            order.Reserve(numNodes);
+            for (int v = 0; v < numNodes; v++) {
+                distance.Append(-1.0);
+                sigma.Append(0.0);
+                dependency.Append(0.0);
+            }
+        }
+    };
+
+    // true if every edge weighs the same, so hop counts order paths like their weights
+    template <typename TKey, typename WeightPolicy>
+    bool HasUniformWeights(const CsrGraph<TKey, WeightPolicy>& graph)
+    {
+        int numNodes = graph.GetNodeCount();
+        if (graph.GetEdgeCount() == 0)
+            return true;
+        double first = 0.0;
+        bool seen = false;
+        for (int v = 0; v < numNodes; v++) {
+            for (int e = graph.RowBegin(v); e < graph.RowEnd(v); e++) {
+                double w = static_cast<double>(graph.GetWeight(e));
+                if (!seen) {
+                    first = w;
+                    seen = true;
+                }
+                else if (w != first) {
+                    return false;
+                }
+            }
+        }
+        return first > 0.0;
+    }
+
+    template <typename TKey, typename WeightPolicy>
+    void SearchBfs(const CsrGraph<TKey, WeightPolicy>& graph, int source, SearchState& state)
+    {
+        double* distance = state.distance.data();
+        double* sigma = state.sigma.data();
+        distance[source] = 0.0;
+        sigma[source] = 1.0;
+        state.order.Append(source);
+        for (int head = 0; head < state.order.GetLength(); head++) {
+            int u = state.order[head];
+            double next = distance[u] + 1.0;
+            for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                int v = graph.GetTarget(e);
+                if (distance[v] < 0.0) {
+                    distance[v] = next;
+                    state.order.Append(v);
+                }
+                // branch-free: whether v is one level further is unpredictable
+                sigma[v] += distance[v] == next ? sigma[u] : 0.0;
+            }
+        }
+    }
+
+    // sigma[v] is complete when v is settled: all of its predecessors are strictly closer
+    template <typename TKey, typename WeightPolicy>
+    void SearchDijkstra(const CsrGraph<TKey, WeightPolicy>& graph, int source, SearchState& state)
+    {
+        BinaryHeap<Pair<double, int>>& heap = state.heap;
+        state.distance[source] = 0.0;
+        state.sigma[source] = 1.0;
+        heap.Push(Pair<double, int>(0.0, source));
+        while (!heap.IsEmpty()) {
+            Pair<double, int> top = heap.Pop();
+            int u = top.value;
+            if (top.key != state.distance[u])
+                continue;
+            state.order.Append(u);
+            for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                int v = graph.GetTarget(e);
+                double newDist = top.key + static_cast<double>(graph.GetWeight(e));
+                if (state.distance[v] < 0.0 || newDist < state.distance[v]) {
+                    state.distance[v] = newDist;
+                    state.sigma[v] = state.sigma[u];
+                    heap.Push(Pair<double, int>(newDist, v));
+                }
+                else if (newDist == state.distance[v]) {
+                    state.sigma[v] += state.sigma[u];
+                }
+            }
+        }
+    }
+
+    // Walks the settled vertices backwards; the successors w of v on shortest paths are the
+    // out-neighbors with distance[w] == distance[v] + weight, and they are finished before v.
+    // Adds scale * dependency of every vertex other than the source to centrality, then resets state.
+    // A finished vertex keeps (1 + dependency) / sigma, the share it passes on per path.
+    template <typename TKey, typename WeightPolicy>
+    void Accumulate(const CsrGraph<TKey, WeightPolicy>& graph, int source, bool uniform, double scale,
+        SearchState& state, DynamicArray<double>& centrality)
+    {
+        const double* distance = state.distance.data();
+        const double* sigma = state.sigma.data();
+        double* share = state.dependency.data();
+        for (int i = state.order.GetLength() - 1; i >= 0; i--) {
+            int v = state.order[i];
+            double sum = 0.0;
+            for (int e = graph.RowBegin(v); e < graph.RowEnd(v); e++) {
+                int w = graph.GetTarget(e);
+                double step = uniform ? 1.0 : static_cast<double>(graph.GetWeight(e));
+                sum += distance[w] == distance[v] + step ? share[w] : 0.0;
+            }
+            double dependency = sigma[v] * sum;
+            if (v != source) centrality[v] += scale * dependency;
+            share[v] = (1.0 + dependency) / sigma[v];
+        }
+        for (int i = 0; i < state.order.GetLength(); i++) {
+            int v = state.order[i];
+            state.distance[v] = -1.0;
+            state.sigma[v] = 0.0;
+            state.dependency[v] = 0.0;
+        }
+        state.order.Truncate(0);
+    }
+
+    // Dependencies of all the given sources, each multiplied by scale
+    template <typename TKey, typename WeightPolicy>
+    DynamicArray<double> FromSources(const CsrGraph<TKey, WeightPolicy>& graph, const DynamicArray<int>& sources,
+        double scale)
+    {
+        int numNodes = graph.GetNodeCount();
+        bool uniform = HasUniformWeights(graph);
+        if (!uniform) {
+            for (int e = 0; e < graph.GetEdgeCount(); e++) {
+                if (!(graph.GetWeight(e) > 0))
+                    throw std::invalid_argument("BetweennessCentrality: edge weights must be positive");
+            }
+        }
+        // an undirected path is found from both of its ends
+        if (!graph.IsDirected()) scale *= 0.5;
+
+        int threads = GetThreadCount();
+        DynamicArray<DynamicArray<double>> local(threads);
+        DynamicArray<SearchState> states(threads);
+        for (int t = 0; t < threads; t++) {
+            local.Append(DynamicArray<double>());
+            states.Append(SearchState());
+        }
+        // grain 1, since a single search is already a large piece of work; the pool still raises it
+        // to 1/8 of a thread's share of the sources, so that a block holds up to that many
+        ParallelForBlocks(0, sources.GetLength(), [&](int blockBegin, int blockEnd, int worker) {
+            DynamicArray<double>& centrality = local[worker];
+            if (centrality.GetLength() == 0) {
+                centrality.Reserve(numNodes);
+                for (int v = 0; v < numNodes; v++) {
+                    centrality.Append(0.0);
+                }
+            }
+            SearchState& state = states[worker];
+            state.Prepare(numNodes);
+            for (int i = blockBegin; i < blockEnd; i++) {
+                if (uniform) SearchBfs(graph, sources[i], state);
+                else SearchDijkstra(graph, sources[i], state);
+                Accumulate(graph, sources[i], uniform, scale, state, centrality);
+            }
+        }, 1);
+
+        DynamicArray<double> result(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            double sum = 0.0;
+            for (int t = 0; t < threads; t++) {
+                if (local[t].GetLength() > 0) sum += local[t][v];
+            }
+            result.Append(sum);
+        }
+        return result;
+    }
+
+}
+
+// Exact betweenness of every vertex, O(V * E) for uniform weights and O(V * E log V) otherwise
+template <typename TKey, typename WeightPolicy>
+DynamicArray<double> BetweennessCentrality(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    DynamicArray<int> sources(graph.GetNodeCount());
+    for (int v = 0; v < graph.GetNodeCount(); v++) {
+        sources.Append(v);
+    }
+    return BetweennessDetail::FromSources(graph, sources, 1.0);
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<double> BetweennessCentrality(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return BetweennessCentrality(CsrGraph<TKey, ExactWeights<WeightType>>(graph));
+}
+
+// Sources needed so that, with probability at least 1 - delta, every estimate of
+// ApproximateBetweenness is within epsilon * n * (n - 2) of the exact value (half of that for
+// undirected graphs), i.e. within epsilon after normalizing by the number of pairs.
+// A source adds between 0 and n - 2 to a vertex, so Hoeffding's bound with a union bound over
+// the n vertices gives k >= ln(2n / delta) / (2 epsilon^2), independent of the size of the graph.
+inline int BetweennessSampleCount(int numNodes, double epsilon, double delta)
+{
+    if (!(epsilon > 0.0) || !(delta > 0.0 && delta < 1.0))
+        throw std::invalid_argument("BetweennessSampleCount: epsilon must be positive and delta in (0, 1)");
+    double k = std::ceil(std::log(2.0 * (numNodes > 1 ? numNodes : 1) / delta) / (2.0 * epsilon * epsilon));
+    return k < numNodes ? static_cast<int>(k) : numNodes;
+}
+
+// Brandes-Pich estimate from BetweennessSampleCount(n, epsilon, delta) sources drawn without
+// replacement, scaled by n / k. Falls back to the exact computation when k reaches n.
+// The same seed draws the same sources.
+template <typename TKey, typename WeightPolicy>
+DynamicArray<double> ApproximateBetweenness(const CsrGraph<TKey, WeightPolicy>& graph, double epsilon,
+    double delta = 0.1, uint64_t seed = 1)
+{
+    int numNodes = graph.GetNodeCount();
+    int k = BetweennessSampleCount(numNodes, epsilon, delta);
+    if (k >= numNodes)
+        return BetweennessCentrality(graph);
+
+    // partial Fisher-Yates shuffle: the first k entries are a uniform sample
+    DynamicArray<int> vertices(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        vertices.Append(v);
+    }
+    std::mt19937_64 random(seed);
+    DynamicArray<int> sources(k);
+    for (int i = 0; i < k; i++) {
+        int j = i + static_cast<int>(random() % static_cast<uint64_t>(numNodes - i));
+        vertices.Swap(vertices[i], vertices[j]);
+        sources.Append(vertices[i]);
+    }
+    return BetweennessDetail::FromSources(graph, sources, static_cast<double>(numNodes) / k);
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<double> ApproximateBetweenness(const Graph<TKey, WeightType, Direction>& graph, double epsilon,
+    double delta = 0.1, uint64_t seed = 1)
+{
+    return ApproximateBetweenness(CsrGraph<TKey, ExactWeights<WeightType>>(graph), epsilon, delta, seed);
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include "CsrGraph.h"
+#include "GraphTraversal.h"
+#include "GraphUtils.h"
+#include "Pair.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Read-only adjacency with the outgoing rows compressed: every row is sorted, and its
+// target ids are delta-encoded as LEB128 varints (7 bits per byte, high bit = more bytes follow).
+// A row is its degree, the zigzag-encoded difference of the first target and the row vertex,
+// then the gaps between consecutive targets. Weights are kept uncompressed in row order.
+template <typename TKey, typename WeightPolicy = ExactWeights<double>>
+class CompressedGraph {
+public:
+    using StorageType = typename WeightPolicy::StorageType;
+    using ValueType = typename WeightPolicy::ValueType;
+
+private:
+    DynamicArray<TKey> Nodes;
+    HashTable<TKey, int> NodeIndex;
+    // byte position of every row in Bytes, and index of its first weight in Weights
+    DynamicArray<int> ByteOffsets;
+    DynamicArray<int> WeightOffsets;
+    DynamicArray<uint8_t> Bytes;
+    DynamicArray<StorageType> Weights;
+    WeightPolicy Policy;
+    // undirected graphs keep every edge in the rows of both endpoints, like CsrGraph
+    bool Directed;
+
+    void WriteVarint(uint32_t value) {
+        while (value >= 0x80) {
+            Bytes.Append(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        Bytes.Append(static_cast<uint8_t>(value));
+    }
+
+    static uint32_t ReadVarint(const uint8_t* bytes, int& position) {
+        uint32_t value = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            byte = bytes[position++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+    static uint32_t ZigZag(int value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    static int UnZigZag(uint32_t value) {
+        return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+    }
+
+    explicit CompressedGraph(bool directed)
+        : Nodes(), NodeIndex(11), ByteOffsets(), WeightOffsets(), Bytes(), Weights(), Policy(), Directed(directed) {}
+
+    // Encodes the length entries at row as the row of v, the next one in id order; sorts them by
+    // target first
+    void AppendRow(int v, Pair<int, ValueType>* row, int length) {
+        ByteOffsets.Append(Bytes.GetLength());
+        WeightOffsets.Append(Weights.GetLength());
+        if (length > 1) {
+            std::sort(row, row + length);
+        }
+        WriteVarint(static_cast<uint32_t>(length));
+        for (int i = 0; i < length; i++) {
+            if (i == 0) WriteVarint(ZigZag(row[0].key - v));
+            else WriteVarint(static_cast<uint32_t>(row[i].key - row[i - 1].key));
+            Weights.Append(Policy.Encode(row[i].value));
+        }
+    }
+
+public:
+    template <typename CsrPolicy>
+    explicit CompressedGraph(const CsrGraph<TKey, CsrPolicy>& graph)
+        : Nodes(graph.GetNodeCount()), NodeIndex(graph.GetNodeCount() * 2 + 11),
+          ByteOffsets(graph.GetNodeCount() + 1), WeightOffsets(graph.GetNodeCount() + 1),
+          Bytes(graph.GetEdgeCount() * 2 + 1), Weights(graph.GetEdgeCount() + 1), Policy(),
+          Directed(graph.IsDirected()) {
+        int numNodes = graph.GetNodeCount();
+        double lo = 0.0, hi = 0.0;
+        for (int e = 0; e < graph.GetEdgeCount(); e++) {
+            double w = static_cast<double>(graph.GetWeight(e));
+            if (e == 0 || w < lo) lo = w;
+            if (e == 0 || w > hi) hi = w;
+        }
+        Policy.Prepare(lo, hi);
+
+        DynamicArray<Pair<int, ValueType>> row;
+        for (int v = 0; v < numNodes; v++) {
+            Nodes.Append(graph.GetVertex(v));
+            NodeIndex.insert(graph.GetVertex(v), v);
+            row.Truncate(0);
+            for (int e = graph.RowBegin(v); e < graph.RowEnd(v); e++) {
+                row.Append(Pair<int, ValueType>(graph.GetTarget(e), static_cast<ValueType>(graph.GetWeight(e))));
+            }
+            AppendRow(v, row.data(), row.GetLength());
+        }
+        ByteOffsets.Append(Bytes.GetLength());
+        WeightOffsets.Append(Weights.GetLength());
+    }
+
+    template <typename WeightType, typename Direction>
+    explicit CompressedGraph(const Graph<TKey, WeightType, Direction>& graph)
+        : CompressedGraph(CsrGraph<TKey, ExactWeights<WeightType>>(graph)) {}
+
+    // Builds the rows straight from an edge stream (StreamingGraph.h) without a Graph or a CsrGraph
+    // in memory; Direction (Directed or Undirected, as for Graph) says how to read the records, since
+    // a stream does not know it. The first pass finds the weight range for the policy. Vertex v gets
+    // the key stream.GetVertex(v).
+    // Directed: every record is an arc of the row of its source. The records must be grouped by
+    // increasing source, as SaveToFile writes a directed graph, and one more pass encodes each row
+    // once its last record is read, so only one row is buffered.
+    // Undirected: every record is an edge, stored in the rows of both endpoints (once for a loop),
+    // so it may come in any order, as SaveToFile writes an undirected graph with each edge once.
+    // Rows are collected for ranges of vertices with at most arcsPerPass entries (or one vertex),
+    // one pass per range.
+    template <typename Direction, typename EdgeStream>
+    static CompressedGraph FromEdgeStream(EdgeStream& stream, int arcsPerPass = 1 << 22) {
+        int numNodes = stream.GetNodeCount();
+        int from, to, last = 0;
+        typename EdgeStream::Weight weight;
+        double lo = 0.0, hi = 0.0;
+        long long arcCount = 0;
+        // row lengths of the undirected rows
+        int rows = Direction::IsDirected ? 0 : numNodes;
+        DynamicArray<int> degree(rows);
+        for (int v = 0; v < rows; v++) {
+            degree.Append(0);
+        }
+        stream.Rewind();
+        for (long long records = 0; stream.Next(from, to, weight); records++) {
+            if (Direction::IsDirected) {
+                if (from < last)
+                    throw std::invalid_argument("CompressedGraph: edges are not grouped by increasing source");
+                last = from;
+                arcCount++;
+            }
+            else {
+                degree[from]++;
+                if (to != from) degree[to]++;
+                arcCount += to != from ? 2 : 1;
+            }
+            double w = static_cast<double>(weight);
+            if (records == 0 || w < lo) lo = w;
+            if (records == 0 || w > hi) hi = w;
+        }
+
+        CompressedGraph graph(Direction::IsDirected);
+        graph.Nodes = DynamicArray<TKey>(numNodes);
+        graph.NodeIndex = HashTable<TKey, int>(numNodes * 2 + 11);
+        graph.ByteOffsets = DynamicArray<int>(numNodes + 1);
+        graph.WeightOffsets = DynamicArray<int>(numNodes + 1);
+        graph.Bytes = DynamicArray<uint8_t>(static_cast<int>(arcCount * 2 + 1));
+        graph.Weights = DynamicArray<StorageType>(static_cast<int>(arcCount + 1));
+        graph.Policy.Prepare(lo, hi);
+        for (int v = 0; v < numNodes; v++) {
+            graph.Nodes.Append(stream.GetVertex(v));
+            graph.NodeIndex.insert(stream.GetVertex(v), v);
+        }
+
+        DynamicArray<Pair<int, ValueType>> row;
+        if (Direction::IsDirected) {
+            int v = 0;
+            stream.Rewind();
+            while (stream.Next(from, to, weight)) {
+                // rows without edges before from are empty
+                while (v < from) {
+                    graph.AppendRow(v++, row.data(), row.GetLength());
+                    row.Truncate(0);
+                }
+                row.Append(Pair<int, ValueType>(to, static_cast<ValueType>(weight)));
+            }
+            while (v < numNodes) {
+                graph.AppendRow(v++, row.data(), row.GetLength());
+                row.Truncate(0);
+            }
+        }
+        else {
+            // fill[v - begin] is the next free slot of the row of v in row
+            DynamicArray<int> fill;
+            for (int begin = 0, end = 0; begin < numNodes; begin = end) {
+                long long arcs = 0;
+                fill.Truncate(0);
+                while (end < numNodes && (end == begin || arcs + degree[end] <= arcsPerPass)) {
+                    fill.Append(static_cast<int>(arcs));
+                    arcs += degree[end++];
+                }
+                row.Truncate(0);
+                for (long long i = 0; i < arcs; i++) {
+                    row.Append(Pair<int, ValueType>());
+                }
+                stream.Rewind();
+                while (stream.Next(from, to, weight)) {
+                    ValueType value = static_cast<ValueType>(weight);
+                    if (from >= begin && from < end) row[fill[from - begin]++] = Pair<int, ValueType>(to, value);
+                    if (to != from && to >= begin && to < end) row[fill[to - begin]++] = Pair<int, ValueType>(from, value);
+                }
+                // every slot now points past its row, so a row starts degree entries before it
+                for (int v = begin; v < end; v++) {
+                    graph.AppendRow(v, row.data() + fill[v - begin] - degree[v], degree[v]);
+                }
+            }
+        }
+        graph.ByteOffsets.Append(graph.Bytes.GetLength());
+        graph.WeightOffsets.Append(graph.Weights.GetLength());
+        return graph;
+    }
+
+    int GetNodeCount() const {
+        return Nodes.GetLength();
+    }
+
+    int GetEdgeCount() const {
+        return Weights.GetLength();
+    }
+
+    bool IsDirected() const {
+        return Directed;
+    }
+
+    TKey GetVertex(int index) const {
+        if (index < 0 || index >= Nodes.GetLength())
+            throw std::out_of_range("GetVertex index out of range");
+        return Nodes[index];
+    }
+
+    int FindNodeIndex(const TKey& node) const {
+        const int* index = NodeIndex.find(node);
+        return index ? *index : -1;
+    }
+
+    int GetDegree(int v) const {
+        return WeightOffsets[v + 1] - WeightOffsets[v];
+    }
+
+    // Calls visit(target, weight) for the row of v in increasing target order
+    template <typename Visit>
+    void ForEachNeighbor(int v, Visit visit) const {
+        const uint8_t* bytes = Bytes.data();
+        int position = ByteOffsets[v];
+        int degree = static_cast<int>(ReadVarint(bytes, position));
+        int weight = WeightOffsets[v];
+        int target = v;
+        for (int i = 0; i < degree; i++) {
+            uint32_t code = ReadVarint(bytes, position);
+            target = i == 0 ? v + UnZigZag(code) : target + static_cast<int>(code);
+            visit(target, Policy.Decode(Weights[weight + i]));
+        }
+    }
+
+    // Bytes of the encoded rows per edge, times 8
+    double BitsPerEdge() const {
+        return GetEdgeCount() > 0 ? 8.0 * Bytes.GetLength() / GetEdgeCount() : 0.0;
+    }
+
+    // Bytes held by the offset, id and weight arrays
+    size_t MemoryUsage() const {
+        return sizeof(int) * (ByteOffsets.GetLength() + WeightOffsets.GetLength()) +
+            Bytes.GetLength() + sizeof(StorageType) * Weights.GetLength();
+    }
+};
+
+// Top-down BFS decoding the rows on the fly
+template <typename TKey, typename WeightPolicy>
+BfsResult BreadthFirstSearch(const CompressedGraph<TKey, WeightPolicy>& graph, int source)
+{
+    return QueueBfs(graph, source);
+}
+
+// Binary-heap Dijkstra decoding the rows on the fly
+template <typename TKey, typename WeightPolicy>
+SsspResult DijkstraDistances(const CompressedGraph<TKey, WeightPolicy>& graph, int source)
+{
+    return HeapDijkstra(graph, source);
+}
@@ -0,0 +1,314 @@
+#pragma once
+#include "DynamicArray.h"
+#include "HashTable.h"
+#include "Graph.h"
+#include "Pair.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Weight storage policies for CsrGraph: how a weight is kept in the weight array
+// and how it is turned back into a value for the algorithms.
+template <typename WeightType>
+struct ExactWeights {
+    using StorageType = WeightType;
+    using ValueType = WeightType;
+
+    void Prepare(double, double) {}
+
+    template <typename W>
+    StorageType Encode(W w) const {
+        return static_cast<StorageType>(w);
+    }
+
+    ValueType Decode(StorageType s) const {
+        return s;
+    }
+};
+
+struct FloatWeights {
+    using StorageType = float;
+    using ValueType = float;
+
+    void Prepare(double, double) {}
+
+    template <typename W>
+    StorageType Encode(W w) const {
+        return static_cast<float>(w);
+    }
+
+    ValueType Decode(StorageType s) const {
+        return s;
+    }
+};
+
+// Maps weights linearly onto [0, 65535] between the smallest and the largest weight of the graph
+struct QuantizedWeights {
+    using StorageType = uint16_t;
+    using ValueType = double;
+
+    double minWeight = 0.0;
+    double scale = 0.0;
+
+    void Prepare(double lo, double hi) {
+        minWeight = lo;
+        scale = hi > lo ? (hi - lo) / 65535.0 : 0.0;
+    }
+
+    template <typename W>
+    StorageType Encode(W w) const {
+        if (scale == 0.0) return 0;
+        double q = std::round((static_cast<double>(w) - minWeight) / scale);
+        if (q < 0.0) q = 0.0;
+        if (q > 65535.0) q = 65535.0;
+        return static_cast<StorageType>(q);
+    }
+
+    ValueType Decode(StorageType s) const {
+        return minWeight + s * scale;
+    }
+};
+
+// Read-only snapshot of a Graph with dense vertex ids (the node order of the Graph).
+// Edges are kept as a struct of arrays: the row of vertex i spans
+// [Offsets[i], Offsets[i + 1]) in Targets and Weights.
+// Snapshots of directed graphs also keep the incoming rows (InOffsets/Sources/InWeights);
+// for undirected graphs the incoming rows alias the outgoing ones. An undirected edge {u, v}
+// is stored in both rows, as (u, v) and (v, u), so GetEdgeCount() is twice the number of
+// undirected edges: every kernel reads a vertex's neighbors as one contiguous row.
+template <typename TKey, typename WeightPolicy = ExactWeights<double>>
+class CsrGraph {
+public:
+    using StorageType = typename WeightPolicy::StorageType;
+    using ValueType = typename WeightPolicy::ValueType;
+
+private:
+    DynamicArray<TKey> Nodes;
+    HashTable<TKey, int> NodeIndex;
+    DynamicArray<int> Offsets;
+    DynamicArray<int> Targets;
+    DynamicArray<StorageType> Weights;
+    DynamicArray<int> InOffsets;
+    DynamicArray<int> Sources;
+    DynamicArray<StorageType> InWeights;
+    WeightPolicy Policy;
+    bool Directed;
+
+    // Rows of the permuted arrays: new row n is old row oldIndex[n] with renumbered, sorted targets
+    static void PermuteRows(const DynamicArray<int>& offsets, const DynamicArray<int>& targets,
+        const DynamicArray<StorageType>& weights, const DynamicArray<int>& newIndex, const DynamicArray<int>& oldIndex,
+        DynamicArray<int>& newOffsets, DynamicArray<int>& newTargets, DynamicArray<StorageType>& newWeights) {
+        int numNodes = oldIndex.GetLength();
+        newOffsets = DynamicArray<int>(numNodes + 1);
+        newTargets = DynamicArray<int>(targets.GetLength());
+        newWeights = DynamicArray<StorageType>(weights.GetLength());
+        newOffsets.Append(0);
+        DynamicArray<Pair<int, StorageType>> row;
+        for (int n = 0; n < numNodes; n++) {
+            int old = oldIndex[n];
+            row.Truncate(0);
+            for (int e = offsets[old]; e < offsets[old + 1]; e++) {
+                row.Append(Pair<int, StorageType>(newIndex[targets[e]], weights[e]));
+            }
+            if (row.GetLength() > 1) {
+                std::sort(row.begin(), row.end());
+            }
+            for (int i = 0; i < row.GetLength(); i++) {
+                newTargets.Append(row[i].key);
+                newWeights.Append(row[i].value);
+            }
+            newOffsets.Append(newTargets.GetLength());
+        }
+    }
+
+public:
+    CsrGraph() : Nodes(), NodeIndex(11), Directed(false) {
+        Offsets.Append(0);
+    }
+
+    template <typename WeightType, typename Direction>
+    explicit CsrGraph(const Graph<TKey, WeightType, Direction>& graph) : CsrGraph() {
+        Build(graph);
+    }
+
+    template <typename WeightType, typename Direction>
+    void Build(const Graph<TKey, WeightType, Direction>& graph) {
+        int numNodes = graph.GetNodeCount();
+        Nodes = DynamicArray<TKey>(numNodes);
+        NodeIndex = HashTable<TKey, int>(numNodes * 2 + 11);
+        Offsets = DynamicArray<int>(numNodes + 1);
+        InOffsets = DynamicArray<int>();
+        Sources = DynamicArray<int>();
+        InWeights = DynamicArray<StorageType>();
+        Policy = WeightPolicy();
+        Directed = Direction::IsDirected;
+
+        for (int i = 0; i < numNodes; i++) {
+            TKey node = graph.GetVertex(i);
+            Nodes.Append(node);
+            NodeIndex.insert(node, i);
+        }
+
+        // first pass: row sizes and the weight range for the policy
+        int numEdges = 0;
+        double lo = 0.0, hi = 0.0;
+        Offsets.Append(0);
+        for (int i = 0; i < numNodes; i++) {
+            graph.ForEachEdge(i, [&](const MyWeightedEdge<TKey, WeightType>& edge) {
+                double w = static_cast<double>(edge.GetWeight());
+                if (numEdges == 0 || w < lo) lo = w;
+                if (numEdges == 0 || w > hi) hi = w;
+                numEdges++;
+            });
+            Offsets.Append(numEdges);
+        }
+        Policy.Prepare(lo, hi);
+
+        Targets = DynamicArray<int>(numEdges);
+        Weights = DynamicArray<StorageType>(numEdges);
+        // second pass: the rows, read in place like the first
+        for (int i = 0; i < numNodes; i++) {
+            graph.ForEachNeighbor(i, [&](int target, WeightType weight) {
+                Targets.Append(target);
+                Weights.Append(Policy.Encode(weight));
+            });
+        }
+
+        if (Directed) {
+            InOffsets = DynamicArray<int>(numNodes + 1);
+            Sources = DynamicArray<int>(numEdges);
+            InWeights = DynamicArray<StorageType>(numEdges);
+            InOffsets.Append(0);
+            for (int i = 0; i < numNodes; i++) {
+                graph.ForEachInNeighbor(i, [&](int source, WeightType weight) {
+                    Sources.Append(source);
+                    InWeights.Append(Policy.Encode(weight));
+                });
+                InOffsets.Append(Sources.GetLength());
+            }
+        }
+    }
+
+    // Copy in which vertex i becomes vertex newIndex[i] (newIndex must be a permutation);
+    // the rows of the copy are sorted by target id
+    CsrGraph Permute(const DynamicArray<int>& newIndex) const {
+        int numNodes = GetNodeCount();
+        if (newIndex.GetLength() != numNodes)
+            throw std::invalid_argument("Permute: mapping size differs from the node count");
+        DynamicArray<int> oldIndex(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            oldIndex.Append(-1);
+        }
+        for (int i = 0; i < numNodes; i++) {
+            int to = newIndex[i];
+            if (to < 0 || to >= numNodes || oldIndex[to] != -1)
+                throw std::invalid_argument("Permute: mapping is not a permutation");
+            oldIndex[to] = i;
+        }
+
+        CsrGraph result;
+        result.Nodes = DynamicArray<TKey>(numNodes);
+        result.NodeIndex = HashTable<TKey, int>(numNodes * 2 + 11);
+        for (int n = 0; n < numNodes; n++) {
+            result.Nodes.Append(Nodes[oldIndex[n]]);
+            result.NodeIndex.insert(Nodes[oldIndex[n]], n);
+        }
+        result.Policy = Policy;
+        result.Directed = Directed;
+        PermuteRows(Offsets, Targets, Weights, newIndex, oldIndex, result.Offsets, result.Targets, result.Weights);
+        if (Directed) {
+            PermuteRows(InOffsets, Sources, InWeights, newIndex, oldIndex, result.InOffsets, result.Sources, result.InWeights);
+        }
+        return result;
+    }
+
+    bool IsDirected() const {
+        return Directed;
+    }
+
+    int GetNodeCount() const {
+        return Nodes.GetLength();
+    }
+
+    // Number of stored (directed) adjacency entries
+    int GetEdgeCount() const {
+        return Targets.GetLength();
+    }
+
+    TKey GetVertex(int index) const {
+        if (index < 0 || index >= Nodes.GetLength())
+            throw std::out_of_range("GetVertex index out of range");
+        return Nodes[index];
+    }
+
+    int FindNodeIndex(const TKey& node) const {
+        if (!NodeIndex.exist(node))
+            return -1;
+        return NodeIndex.get(node);
+    }
+
+    int RowBegin(int index) const {
+        return Offsets[index];
+    }
+
+    int RowEnd(int index) const {
+        return Offsets[index + 1];
+    }
+
+    int GetDegree(int index) const {
+        return Offsets[index + 1] - Offsets[index];
+    }
+
+    int GetTarget(int edge) const {
+        return Targets[edge];
+    }
+
+    ValueType GetWeight(int edge) const {
+        return Policy.Decode(Weights[edge]);
+    }
+
+    int InRowBegin(int index) const {
+        return Directed ? InOffsets[index] : Offsets[index];
+    }
+
+    int InRowEnd(int index) const {
+        return Directed ? InOffsets[index + 1] : Offsets[index + 1];
+    }
+
+    int GetInDegree(int index) const {
+        return InRowEnd(index) - InRowBegin(index);
+    }
+
+    int GetSource(int inEdge) const {
+        return Directed ? Sources[inEdge] : Targets[inEdge];
+    }
+
+    ValueType GetInWeight(int inEdge) const {
+        return Policy.Decode(Directed ? InWeights[inEdge] : Weights[inEdge]);
+    }
+
+    // Calls visit(target, weight) for the outgoing row of index
+    template <typename Visit>
+    void ForEachNeighbor(int index, Visit visit) const {
+        for (int e = RowBegin(index); e < RowEnd(index); e++) {
+            visit(GetTarget(e), GetWeight(e));
+        }
+    }
+
+    // Calls visit(source, weight) for the incoming row of index
+    template <typename Visit>
+    void ForEachInNeighbor(int index, Visit visit) const {
+        for (int e = InRowBegin(index); e < InRowEnd(index); e++) {
+            visit(GetSource(e), GetInWeight(e));
+        }
+    }
+
+    // Bytes held by the offset, id and weight arrays
+    size_t MemoryUsage() const {
+        return sizeof(int) * (Offsets.GetLength() + Targets.GetLength() +
+            InOffsets.GetLength() + Sources.GetLength()) +
+            sizeof(StorageType) * (Weights.GetLength() + InWeights.GetLength());
+    }
+};
@@ -1,36 +1,67 @@
 #pragma once
 
+#include <cstring>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include "Hashing.h"
 #include "Pair.h"
 
 //   -
+// Without a seed, integers hash to themselves: HashTable reduces hashes modulo a prime, which
+// spreads them well, and neighboring keys land in neighboring slots (CsrGraph construction
+// is about 1.5x slower with mixed integer keys). With a seed they are mixed like everything else.
+// Floating-point keys are mixed with MixHash, other types go through std::hash and are mixed
+// afterwards. A hasher keeps the hash seed that was set when it was created.
 template <typename Key>
 struct DefaultHash {
+    uint64_t seed = GetHashSeed();
+
     size_t operator()(const Key& key) const {
-        return std::hash<Key>()(key);
+        if constexpr (std::is_integral<Key>::value || std::is_enum<Key>::value) {
+            uint64_t value = static_cast<uint64_t>(key);
+            return static_cast<size_t>(seed == 0 ? value : MixHash(value ^ seed));
+        }
+        else if constexpr (std::is_floating_point<Key>::value) {
+            // 0.0 and -0.0 are equal keys and must hash alike
+            double value = key == 0 ? 0.0 : static_cast<double>(key);
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return static_cast<size_t>(MixHash(bits ^ seed));
+        }
+        else {
+            return static_cast<size_t>(MixHash(static_cast<uint64_t>(std::hash<Key>()(key)) ^ seed));
+        }
     }
 };
 
-//   Pair<int, int>
 template <>
-struct DefaultHash<Pair<int, int>> {
-    size_t operator()(const Pair<int, int>& keyPair) const {
-        return std::hash<int>()(keyPair.key) ^ (std::hash<int>()(keyPair.value) << 1);
+struct DefaultHash<std::string> {
+    uint64_t seed = GetHashSeed();
+
+    size_t operator()(const std::string& key) const {
+        return static_cast<size_t>(HashBytes(key.data(), key.size(), seed));
     }
 };
 
-//   Pair<double, double>
-template <>
-struct DefaultHash<Pair<double, double>> {
-    size_t operator()(const Pair<double, double>& keyPair) const {
-        return std::hash<double>()(keyPair.key) ^ (std::hash<double>()(keyPair.value) << 1);
+// Both halves are hashed and combined in order, so (a, b) and (b, a) do not collide
+template <typename K, typename V>
+struct DefaultHash<Pair<K, V>> {
+    DefaultHash<K> first;
+    DefaultHash<V> second;
+
+    size_t operator()(const Pair<K, V>& keyPair) const {
+        return static_cast<size_t>(CombineHashes(first(keyPair.key), second(keyPair.value)));
     }
 };
 
-//   Pair<std::string, std::string>
-template <>
-struct DefaultHash<Pair<std::string, std::string>> {
-    size_t operator()(const Pair<std::string, std::string>& keyPair) const {
-        return std::hash<std::string>()(keyPair.key) ^ (std::hash<std::string>()(keyPair.value) << 1);
+// Always mixes, also unseeded integers: for tables that reduce hashes by a power of two
+// (masking low bits), where identity hashes of strided keys would all collide
+template <typename Key>
+struct MixedHash {
+    DefaultHash<Key> inner;
+
+    size_t operator()(const Key& key) const {
+        return static_cast<size_t>(MixHash(static_cast<uint64_t>(inner(key))));
     }
-};
\ No newline at end of file
+};
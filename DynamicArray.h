@@ -2,11 +2,22 @@
 #include "Sequence.h"
 #include <stdexcept>
 
+// Bounds checks of operator[] are chosen at compile time: on by default, off when NDEBUG is
+// defined (release builds). Define DYNAMIC_ARRAY_BOUNDS_CHECK as 0 or 1 before the first include
+// to choose explicitly; every translation unit of a program must make the same choice.
+#ifndef DYNAMIC_ARRAY_BOUNDS_CHECK
+#ifdef NDEBUG
+#define DYNAMIC_ARRAY_BOUNDS_CHECK 0
+#else
+#define DYNAMIC_ARRAY_BOUNDS_CHECK 1
+#endif
+#endif
+
 template <class T>
 class DynamicArray : public Sequence<T>
 {
 private:
-    T* data;
+    T* buffer;
     int size;
     int capacity;
 
@@ -17,14 +28,18 @@ private:
 
         T* newData = new T[newCapacity];
         for (int i = 0; i < size; ++i) {
-            newData[i] = data[i];
+            newData[i] = buffer[i];
         }
-        delete[] data;
-        data = newData;
+        delete[] buffer;
+        buffer = newData;
         capacity = newCapacity;
     }
 
 public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
     class DynamicArrayIterator : public Sequence<T>::Iterator {
     private:
         T* current;
@@ -51,20 +66,20 @@ public:
     };
 
     DynamicArray() : size(0), capacity(10) {
-        data = new T[capacity];
+        buffer = new T[capacity];
     }
 
     DynamicArray(int initialCapacity) : size(0), capacity(initialCapacity) {
         if (capacity <= 0) capacity = 10;
-        data = new T[capacity];
+        buffer = new T[capacity];
     }
 
     DynamicArray(const DynamicArray<T>& other) {
         size = other.size;
         capacity = other.capacity;
-        data = new T[capacity];
+        buffer = new T[capacity];
         for (int i = 0; i < size; ++i) {
-            data[i] = other.data[i];
+            buffer[i] = other.buffer[i];
         }
     }
 
@@ -73,12 +88,12 @@ public:
             return *this; 
         }
 
-        delete[] data;
+        delete[] buffer;
         size = other.size;
         capacity = other.capacity;
-        data = new T[capacity];
+        buffer = new T[capacity];
         for (int i = 0; i < size; ++i) {
-            data[i] = other.data[i];
+            buffer[i] = other.buffer[i];
         }
         return *this;
     }
@@ -87,50 +102,76 @@ public:
         size = itemsSize;
         capacity = itemsSize * 2;
         if (capacity < 10) capacity = 10;
-        data = new T[capacity];
+        buffer = new T[capacity];
         for (int i = 0; i < size; ++i) {
-            data[i] = items[i];
+            buffer[i] = items[i];
         }
     }
 
     ~DynamicArray() {
-        delete[] data;
+        delete[] buffer;
     }
 
     //  
     const T& operator[](int index) const {
-        if (index < 0 || index >= size) {
+        if (DYNAMIC_ARRAY_BOUNDS_CHECK && (index < 0 || index >= size)) {
             throw std::out_of_range("Index out of range");
         }
-        return data[index];
+        return buffer[index];
     }
 
     T& operator[](int index) {
-        if (index < 0 || index >= size)
+        if (DYNAMIC_ARRAY_BOUNDS_CHECK && (index < 0 || index >= size))
             throw std::out_of_range("Index out of range");
-        return data[index];
+        return buffer[index];
+    }
+
+    // Raw-pointer iterators for range-for and the standard algorithms, without virtual calls
+    // or checks; like data(), they are invalidated when the array grows
+    T* begin() {
+        return buffer;
+    }
+
+    T* end() {
+        return buffer + size;
+    }
+
+    const T* begin() const {
+        return buffer;
+    }
+
+    const T* end() const {
+        return buffer + size;
+    }
+
+    T* data() {
+        return buffer;
+    }
+
+    const T* data() const {
+        return buffer;
     }
 
     T& GetFirstElem() override {
         if (size == 0) throw std::out_of_range("Array is empty");
-        return data[0];
+        return buffer[0];
     }
 
     T& GetLastElem() override {
         if (size == 0) throw std::out_of_range("Array is empty");
-        return data[size - 1];
+        return buffer[size - 1];
     }
 
     T& GetElem(int index) override {
         if (index < 0 || index >= size)
             throw std::out_of_range("Index out of range");
-        return data[index];
+        return buffer[index];
     }
 
     const T& GetElem(int index) const override {
         if (index < 0 || index >= size)
             throw std::out_of_range("Index out of range");
-        return data[index];
+        return buffer[index];
     }
 
     void Swap(T& a, T& b) override {
@@ -160,12 +201,12 @@ public:
             throw std::out_of_range("Insert index out of range");
         }
         if (size >= capacity) {
-            Resize(capacity * 2);
+            Resize(capacity > 0 ? capacity * 2 : 1);
         }
         for (int i = size; i > index; i--) {
-            data[i] = data[i - 1];
+            buffer[i] = buffer[i - 1];
         }
-        data[index] = dataElem;
+        buffer[index] = dataElem;
         size++;
     }
 
@@ -188,7 +229,7 @@ public:
         int length = endIndex - startIndex + 1;
         T* items = new T[length];
         for (int i = 0; i < length; i++) {
-            items[i] = data[startIndex + i];
+            items[i] = buffer[startIndex + i];
         }
         return new DynamicArray<T>(items, length);
     }
@@ -198,22 +239,38 @@ public:
             throw std::out_of_range("RemoveAt: index out of range");
         }
         for (int i = index; i < size - 1; i++) {
-            data[i] = data[i + 1];
+            buffer[i] = buffer[i + 1];
+        }
+        size--;
+    }
+
+    // O(1) removal that moves the last element into the freed slot
+    void SwapRemoveAt(int index) {
+        if (index < 0 || index >= size) {
+            throw std::out_of_range("SwapRemoveAt: index out of range");
         }
+        buffer[index] = buffer[size - 1];
         size--;
     }
 
+    void Truncate(int newSize) {
+        if (newSize < 0 || newSize > size) {
+            throw std::out_of_range("Truncate: size out of range");
+        }
+        size = newSize;
+    }
+
     void Clear() {
-        delete[] data;
-        data = new T[capacity];
+        delete[] buffer;
+        buffer = new T[capacity];
         size = 0;
     }
 
     typename Sequence<T>::Iterator* ToBegin() override {
-        return new DynamicArrayIterator(data);
+        return new DynamicArrayIterator(buffer);
     }
 
     typename Sequence<T>::Iterator* ToEnd() override {
-        return new DynamicArrayIterator(data + size);
+        return new DynamicArrayIterator(buffer + size);
     }
 };
@@ -0,0 +1,183 @@
+#pragma once
+#include "Graph.h"
+#include "GraphUtils.h"
+
+// Keeps a proper coloring of the graph while it changes.
+// Mutations made through this class fix conflicts locally: a new edge between two vertices
+// of the same color recolors the endpoint with the smaller degree, a removed edge lets its
+// endpoints drop to a smaller free color. Each update costs O(local degree).
+// When the number of colors drifts above rebalanceFactor times the count of the last full
+// coloring, the graph is recolored with GraphColoring. Mutations made directly on the graph
+// are detected through its version counter and also trigger a full recoloring.
+template <typename TKey, typename WeightType = double, typename Direction = Undirected>
+class DynamicColoring {
+private:
+    Graph<TKey, WeightType, Direction>& graph;
+    DynamicArray<int> colors;
+    // usage[c] is the number of vertices with color c
+    DynamicArray<int> usage;
+    int colorCount;
+    int baselineCount;
+    double rebalanceFactor;
+    unsigned long long version;
+
+public:
+    explicit DynamicColoring(Graph<TKey, WeightType, Direction>& graph, double rebalanceFactor = 1.5)
+        : graph(graph), colors(), usage(), colorCount(0), baselineCount(0),
+        rebalanceFactor(rebalanceFactor), version(0) {
+        Rebalance();
+    }
+
+    // Colors in node order, as returned by GraphColoring
+    const DynamicArray<int>& GetColors() {
+        Refresh();
+        return colors;
+    }
+
+    int GetColor(const TKey& vertex) {
+        Refresh();
+        int index = graph.FindNodeIndex(vertex);
+        return index == -1 ? -1 : colors[index];
+    }
+
+    int GetColorCount() {
+        Refresh();
+        return colorCount;
+    }
+
+    void InsertVertex(const TKey& vertex) {
+        unsigned long long before = graph.GetVersion();
+        graph.InsertVertex(vertex);
+        if (!Synced(before))
+            return;
+        colors.Append(-1);
+        SetColor(colors.GetLength() - 1, 0);
+        version = graph.GetVersion();
+    }
+
+    void EraseVertex(const TKey& vertex) {
+        int index = graph.FindNodeIndex(vertex);
+        unsigned long long before = graph.GetVersion();
+        graph.EraseVertex(vertex);
+        if (!Synced(before))
+            return;
+        // Graph moves its last vertex into the erased slot, the colors follow it
+        SetColor(index, -1);
+        colors[index] = colors[colors.GetLength() - 1];
+        colors.SwapRemoveAt(colors.GetLength() - 1);
+        version = graph.GetVersion();
+        MaybeRebalance();
+    }
+
+    void ConnectNodes(const TKey& from, const TKey& to, WeightType weight) {
+        unsigned long long before = graph.GetVersion();
+        graph.ConnectNodes(from, to, weight);
+        if (!Synced(before))
+            return;
+        int u = graph.FindNodeIndex(from);
+        int v = graph.FindNodeIndex(to);
+        if (u != v && colors[u] == colors[v]) {
+            int x = Degree(from) <= Degree(to) ? u : v;
+            SetColor(x, SmallestFreeColor(x));
+        }
+        version = graph.GetVersion();
+        MaybeRebalance();
+    }
+
+    void DisconnectNodes(const TKey& from, const TKey& to) {
+        unsigned long long before = graph.GetVersion();
+        graph.DisconnectNodes(from, to);
+        if (!Synced(before))
+            return;
+        int endpoints[2] = { graph.FindNodeIndex(from), graph.FindNodeIndex(to) };
+        for (int x : endpoints) {
+            int c = SmallestFreeColor(x);
+            if (c < colors[x]) {
+                SetColor(x, c);
+            }
+        }
+        version = graph.GetVersion();
+    }
+
+    // Full greedy recoloring; resets the baseline color count
+    void Rebalance() {
+        colors = GraphColoring(CsrGraph<TKey>(graph));
+        usage = DynamicArray<int>();
+        colorCount = 0;
+        for (int i = 0; i < colors.GetLength(); i++) {
+            int c = colors[i];
+            colors[i] = -1;
+            SetColor(i, c);
+        }
+        baselineCount = colorCount;
+        version = graph.GetVersion();
+    }
+
+private:
+    void Refresh() {
+        if (version != graph.GetVersion()) {
+            Rebalance();
+        }
+    }
+
+    // True when the coloring matched the graph before the last mutation and the mutation changed something
+    bool Synced(unsigned long long before) {
+        if (graph.GetVersion() == before)
+            return false;
+        if (version != before) {
+            Rebalance();
+            return false;
+        }
+        return true;
+    }
+
+    void MaybeRebalance() {
+        if (rebalanceFactor > 0 && colorCount > baselineCount * rebalanceFactor) {
+            Rebalance();
+        }
+    }
+
+    void SetColor(int index, int color) {
+        int old = colors[index];
+        if (old != -1 && --usage[old] == 0) {
+            colorCount--;
+        }
+        colors[index] = color;
+        if (color == -1)
+            return;
+        while (usage.GetLength() <= color) {
+            usage.Append(0);
+        }
+        if (usage[color]++ == 0) {
+            colorCount++;
+        }
+    }
+
+    // Neighbors in both directions, read from the stored list lengths
+    int Degree(const TKey& vertex) const {
+        return graph.GetDegree(vertex) + (Direction::IsDirected ? graph.GetInDegree(vertex) : 0);
+    }
+
+    int SmallestFreeColor(int index) {
+        int degree = Degree(graph.GetVertex(index));
+        DynamicArray<bool> taken(degree + 1);
+        for (int i = 0; i <= degree; i++) {
+            taken.Append(false);
+        }
+        auto mark = [&](int neighbor, WeightType) {
+            int c = neighbor == index ? -1 : colors[neighbor];
+            if (c != -1 && c < taken.GetLength()) {
+                taken[c] = true;
+            }
+        };
+        graph.ForEachNeighbor(index, mark);
+        if constexpr (Direction::IsDirected) {
+            graph.ForEachInNeighbor(index, mark);
+        }
+        int c = 0;
+        while (taken[c]) {
+            c++;
+        }
+        return c;
+    }
+};
@@ -1,7 +1,10 @@
 #pragma once
 #include "DynamicArray.h"
 #include "HashTable.h"
+#include "Parallel.h"
+#include "SharedStorage.h"
 #include "WeightedEdge.h"
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <stdexcept>
@@ -9,6 +12,7 @@
 #include <cstdlib>
 #include <type_traits>
 #include <functional>
+#include <utility>
 
 template <typename TKey>
 struct PathInfo {
@@ -16,21 +20,106 @@ struct PathInfo {
     DynamicArray<TKey> path;
 };
 
+// Directedness policies for Graph
+struct Undirected {
+    static constexpr bool IsDirected = false;
+};
+
+struct Directed {
+    static constexpr bool IsDirected = true;
+};
+
+enum class EdgeOperationType {
+    Connect,
+    Disconnect
+};
+
+// One edge insertion or removal of Graph::ApplyBatch; weight is ignored by Disconnect
 template <typename TKey, typename WeightType = double>
+struct EdgeOperation {
+    EdgeOperationType type;
+    TKey from;
+    TKey to;
+    WeightType weight;
+
+    static EdgeOperation Connect(const TKey& from, const TKey& to, WeightType weight) {
+        return EdgeOperation{ EdgeOperationType::Connect, from, to, weight };
+    }
+
+    static EdgeOperation Disconnect(const TKey& from, const TKey& to) {
+        return EdgeOperation{ EdgeOperationType::Disconnect, from, to, WeightType() };
+    }
+};
+
+template <typename TKey, typename WeightType = double, typename Direction = Undirected>
 class Graph {
 private:
-    DynamicArray<TKey> Nodes;
-    HashTable<TKey, DynamicArray<MyWeightedEdge<TKey, WeightType>>> AdjacencyData;
+    using EdgeList = DynamicArray<MyWeightedEdge<TKey, WeightType>>;
+    using NeighborMap = HashTable<TKey, int>;
+    using EdgeTable = SharedTable<TKey, EdgeList>;
+    using IndexTable = SharedTable<TKey, NeighborMap>;
+
+    // edge lists longer than this get a neighbor -> position map for O(1) membership
+    static constexpr int HubDegreeThreshold = 32;
+
+    // all storage is copy-on-write (SharedStorage.h): copies of a graph share it until written
+    SharedArray<TKey> Nodes;
+    // position of every vertex in Nodes
+    SharedTable<TKey, int> NodeIndex;
+    // outgoing edges; for undirected graphs every edge is listed at both endpoints
+    EdgeTable AdjacencyData;
+    // incoming edges, kept only by directed graphs
+    EdgeTable IncomingData;
+    // neighbor positions of the high-degree vertices of AdjacencyData / IncomingData
+    IndexTable OutNeighborIndex;
+    IndexTable InNeighborIndex;
+    // incremented by every mutation
+    unsigned long long Version;
+
+    // ApplyBatch: one operation as seen by one edge list; list is 2 * node index, + 1 for incoming
+    struct BatchEntry {
+        int list;
+        TKey target;
+        int sequence;
+        bool connect;
+        WeightType weight;
+    };
+
+    // ApplyBatch: the net effect of all operations on one entry of an edge list
+    struct BatchChange {
+        int list;
+        TKey target;
+        // a Disconnect came, and a Connect followed the last Disconnect (or came without one)
+        bool removes;
+        bool adds;
+        // weight of that Connect
+        WeightType weight;
+        // set by the merge if the edge was there before the batch
+        bool present;
+    };
 
 public:
-    Graph() : Nodes(), AdjacencyData(11) {}
+    Graph() : Nodes(), NodeIndex(11), AdjacencyData(11), IncomingData(11),
+        OutNeighborIndex(11), InNeighborIndex(11), Version(0) {}
+
+    static constexpr bool IsDirected() {
+        return Direction::IsDirected;
+    }
+
+    unsigned long long GetVersion() const {
+        return Version;
+    }
+
+    // Independent copy that shares all storage with this graph. Costs O(V / 512) pointer copies;
+    // afterwards a mutation of either graph copies only the storage segments and the edge lists
+    // it touches. Copy construction and assignment behave the same way.
+    Graph Snapshot() const {
+        return *this;
+    }
 
     int FindNodeIndex(const TKey& node) const {
-        for (int i = 0; i < Nodes.GetLength(); i++) {
-            if (Nodes.GetElem(i) == node)
-                return i;
-        }
-        return -1;
+        const int* index = NodeIndex.find(node);
+        return index ? *index : -1;
     }
 
     int GetNodeCount() const {
@@ -51,98 +140,338 @@ public:
         return AdjacencyData.get(vertex);
     }
 
+    // Edges pointing to the vertex; the same list as GetAdjacentVertices for undirected graphs
+    DynamicArray<MyWeightedEdge<TKey, WeightType>> GetIncomingVertices(const TKey& vertex) const {
+        if constexpr (!Direction::IsDirected) {
+            return GetAdjacentVertices(vertex);
+        }
+        else {
+            if (!IncomingData.exist(vertex)) {
+                DynamicArray<MyWeightedEdge<TKey, WeightType>> emptySet;
+                return emptySet;
+            }
+            return IncomingData.get(vertex);
+        }
+    }
+
+    // Number of outgoing edges of the vertex, 0 if it is not in the graph; nothing is copied
+    int GetDegree(const TKey& vertex) const {
+        const EdgeList* edges = AdjacencyData.find(vertex);
+        return edges ? edges->GetLength() : 0;
+    }
+
+    // Number of incoming edges (the outgoing ones for undirected graphs)
+    int GetInDegree(const TKey& vertex) const {
+        const EdgeList* edges = (Direction::IsDirected ? IncomingData : AdjacencyData).find(vertex);
+        return edges ? edges->GetLength() : 0;
+    }
+
+    // Calls visit(edge) for the outgoing edges of the vertex at index without copying its edge list
+    template <typename Visit>
+    void ForEachEdge(int index, Visit visit) const {
+        const EdgeList& edges = *AdjacencyData.find(GetVertex(index));
+        for (int i = 0; i < edges.GetLength(); i++) {
+            visit(edges[i]);
+        }
+    }
+
+    // Calls visit(neighbor index, weight) for the outgoing edges of the vertex at index
+    // without copying its edge list; every neighbor costs one index lookup
+    template <typename Visit>
+    void ForEachNeighbor(int index, Visit visit) const {
+        ForEachEdge(index, [&](const MyWeightedEdge<TKey, WeightType>& edge) {
+            visit(FindNodeIndex(edge.GetNode()), edge.GetWeight());
+        });
+    }
+
+    // Same for the incoming edges (the outgoing ones for undirected graphs)
+    template <typename Visit>
+    void ForEachInNeighbor(int index, Visit visit) const {
+        const EdgeList& edges = *(Direction::IsDirected ? IncomingData : AdjacencyData).find(GetVertex(index));
+        for (int i = 0; i < edges.GetLength(); i++) {
+            visit(FindNodeIndex(edges[i].GetNode()), edges[i].GetWeight());
+        }
+    }
+
     bool HasVertex(const TKey& vertex) const {
         return AdjacencyData.exist(vertex);
     }
 
+    bool HasEdge(const TKey& from, const TKey& to) const {
+        return FindEdgePosition(AdjacencyData, OutNeighborIndex, from, to) != -1;
+    }
+
+    WeightType GetEdgeWeight(const TKey& from, const TKey& to) const {
+        int position = FindEdgePosition(AdjacencyData, OutNeighborIndex, from, to);
+        if (position == -1)
+            throw std::runtime_error("GetEdgeWeight: edge not found");
+        return (*AdjacencyData.find(from))[position].GetWeight();
+    }
+
     void InsertVertex(const TKey& vertex) {
         if (!AdjacencyData.exist(vertex)) {
             DynamicArray<MyWeightedEdge<TKey, WeightType>> edges;
             AdjacencyData.insert(vertex, edges);
+            if constexpr (Direction::IsDirected) {
+                IncomingData.insert(vertex, edges);
+            }
+            NodeIndex.insert(vertex, Nodes.GetLength());
             Nodes.Append(vertex);
+            Version++;
         }
     }
 
+    // Costs O(degree): back edges are swap-removed from the neighbors' lists in place.
+    // The last vertex of the node order takes the place of the erased one.
     void EraseVertex(const TKey& vertex) {
-        if (!AdjacencyData.exist(vertex))
+        const EdgeList* edgesToRemove = std::as_const(AdjacencyData).find(vertex);
+        if (!edgesToRemove)
             return;
 
-        DynamicArray<MyWeightedEdge<TKey, WeightType>> edgesToRemove = AdjacencyData.get(vertex);
-        for (int i = 0; i < edgesToRemove.GetLength(); i++) {
-            TKey neighbor = edgesToRemove[i].GetNode();
-            if (AdjacencyData.exist(neighbor)) {
-                auto theirEdges = AdjacencyData.get(neighbor);
-                for (int j = 0; j < theirEdges.GetLength(); j++) {
-                    if (theirEdges[j].GetNode() == vertex) {
-                        theirEdges.RemoveAt(j);
-                        break;
-                    }
-                }
-                AdjacencyData.insert(neighbor, theirEdges);
+        for (int i = 0; i < edgesToRemove->GetLength(); i++) {
+            TKey neighbor = (*edgesToRemove)[i].GetNode();
+            if (neighbor == vertex) continue;
+            if constexpr (Direction::IsDirected) {
+                RemoveEdge(IncomingData, InNeighborIndex, neighbor, vertex);
+            }
+            else {
+                RemoveEdge(AdjacencyData, OutNeighborIndex, neighbor, vertex);
+            }
+        }
+
+        if constexpr (Direction::IsDirected) {
+            const EdgeList* incomingToRemove = std::as_const(IncomingData).find(vertex);
+            for (int i = 0; i < incomingToRemove->GetLength(); i++) {
+                TKey neighbor = (*incomingToRemove)[i].GetNode();
+                if (neighbor == vertex) continue;
+                RemoveEdge(AdjacencyData, OutNeighborIndex, neighbor, vertex);
             }
+            IncomingData.remove(vertex);
+            InNeighborIndex.remove(vertex);
         }
 
         AdjacencyData.remove(vertex);
+        OutNeighborIndex.remove(vertex);
+        RemoveNodeSlot(vertex);
+        Version++;
+    }
 
-        for (int i = 0; i < Nodes.GetLength(); i++) {
-            if (Nodes[i] == vertex) {
-                Nodes.RemoveAt(i);
-                break;
+    // Erases all given vertices at once: every surviving neighbor list is compacted in a single pass
+    void EraseVertices(const DynamicArray<TKey>& batch) {
+        HashTable<TKey, bool> marked(batch.GetLength() * 2 + 11);
+        DynamicArray<TKey> erased;
+        for (int i = 0; i < batch.GetLength(); i++) {
+            if (AdjacencyData.exist(batch[i]) && !marked.exist(batch[i])) {
+                marked.insert(batch[i], true);
+                erased.Append(batch[i]);
+            }
+        }
+
+        HashTable<TKey, bool> affectedSet(11);
+        DynamicArray<TKey> affected;
+        for (int i = 0; i < erased.GetLength(); i++) {
+            CollectUnmarked(*std::as_const(AdjacencyData).find(erased[i]), marked, affectedSet, affected);
+            if constexpr (Direction::IsDirected) {
+                CollectUnmarked(*std::as_const(IncomingData).find(erased[i]), marked, affectedSet, affected);
             }
         }
+
+        for (int i = 0; i < affected.GetLength(); i++) {
+            CompactEdges(AdjacencyData, OutNeighborIndex, affected[i], marked);
+            if constexpr (Direction::IsDirected) {
+                CompactEdges(IncomingData, InNeighborIndex, affected[i], marked);
+            }
+        }
+
+        for (int i = 0; i < erased.GetLength(); i++) {
+            AdjacencyData.remove(erased[i]);
+            IncomingData.remove(erased[i]);
+            OutNeighborIndex.remove(erased[i]);
+            InNeighborIndex.remove(erased[i]);
+            RemoveNodeSlot(erased[i]);
+        }
+        if (erased.GetLength() > 0) {
+            Version++;
+        }
     }
 
     void ConnectNodes(const TKey& from, const TKey& to, WeightType weight) {
         if (!AdjacencyData.exist(from) || !AdjacencyData.exist(to)) {
             return;
         }
-        {
-            auto edgesFrom = AdjacencyData.get(from);
-            for (int i = 0; i < edgesFrom.GetLength(); i++) {
-                if (edgesFrom[i].GetNode() == to) {
-                    return;
-                }
-            }
-            edgesFrom.Append(MyWeightedEdge<TKey, WeightType>(to, weight));
-            AdjacencyData.insert(from, edgesFrom);
+        if (HasEdge(from, to)) {
+            return;
         }
+        AppendEdge(AdjacencyData, OutNeighborIndex, from, MyWeightedEdge<TKey, WeightType>(to, weight));
+        Version++;
 
-        {
-            auto edgesTo = AdjacencyData.get(to);
-            for (int i = 0; i < edgesTo.GetLength(); i++) {
-                if (edgesTo[i].GetNode() == from) {
-                    return;
-                }
+        if constexpr (Direction::IsDirected) {
+            AppendEdge(IncomingData, InNeighborIndex, to, MyWeightedEdge<TKey, WeightType>(from, weight));
+        }
+        else {
+            if (HasEdge(to, from)) {
+                return;
             }
-            edgesTo.Append(MyWeightedEdge<TKey, WeightType>(from, weight));
-            AdjacencyData.insert(to, edgesTo);
+            AppendEdge(AdjacencyData, OutNeighborIndex, to, MyWeightedEdge<TKey, WeightType>(from, weight));
+        }
+    }
+
+    // Changes the weight of an existing edge (both directions of an undirected edge)
+    void SetEdgeWeight(const TKey& from, const TKey& to, WeightType weight) {
+        int position = FindEdgePosition(AdjacencyData, OutNeighborIndex, from, to);
+        if (position == -1)
+            throw std::runtime_error("SetEdgeWeight: edge not found");
+        (*AdjacencyData.find(from))[position].SetWeight(weight);
+        if constexpr (Direction::IsDirected) {
+            position = FindEdgePosition(IncomingData, InNeighborIndex, to, from);
+            (*IncomingData.find(to))[position].SetWeight(weight);
+        }
+        else {
+            position = FindEdgePosition(AdjacencyData, OutNeighborIndex, to, from);
+            (*AdjacencyData.find(to))[position].SetWeight(weight);
         }
+        Version++;
     }
 
     void DisconnectNodes(const TKey& from, const TKey& to) {
         if (!AdjacencyData.exist(from) || !AdjacencyData.exist(to)) {
             return;
         }
-        {
-            auto edgesFrom = AdjacencyData.get(from);
-            for (int i = 0; i < edgesFrom.GetLength(); i++) {
-                if (edgesFrom[i].GetNode() == to) {
-                    edgesFrom.RemoveAt(i);
-                    break;
-                }
+        if (!HasEdge(from, to)) {
+            return;
+        }
+        Version++;
+        RemoveEdge(AdjacencyData, OutNeighborIndex, from, to);
+        if constexpr (Direction::IsDirected) {
+            RemoveEdge(IncomingData, InNeighborIndex, to, from);
+        }
+        else {
+            RemoveEdge(AdjacencyData, OutNeighborIndex, to, from);
+        }
+    }
+
+    // Applies the operations as if one by one with ConnectNodes / DisconnectNodes, but every
+    // affected edge list is rewritten once: the operations are grouped by list and sorted by
+    // neighbor, and the lists are merged with them in parallel.
+    // All or nothing: the batch is checked first, and an operation with an unknown vertex throws
+    // std::invalid_argument before anything changes. The version is bumped once if the batch changed anything.
+    void ApplyBatch(const DynamicArray<EdgeOperation<TKey, WeightType>>& ops) {
+        if (ops.GetLength() == 0)
+            return;
+        DynamicArray<BatchEntry> entries(ops.GetLength() * 2);
+        for (int i = 0; i < ops.GetLength(); i++) {
+            const EdgeOperation<TKey, WeightType>& op = ops[i];
+            const int* from = NodeIndex.find(op.from);
+            const int* to = NodeIndex.find(op.to);
+            if (!from || !to)
+                throw std::invalid_argument("ApplyBatch: operation with an unknown vertex");
+            bool connect = op.type == EdgeOperationType::Connect;
+            int fromIndex = *from;
+            int toIndex = *to;
+            entries.Append(BatchEntry{ 2 * fromIndex, op.to, i, connect, op.weight });
+            if constexpr (Direction::IsDirected) {
+                entries.Append(BatchEntry{ 2 * toIndex + 1, op.from, i, connect, op.weight });
+            }
+            else if (fromIndex != toIndex) {
+                entries.Append(BatchEntry{ 2 * toIndex, op.from, i, connect, op.weight });
             }
-            AdjacencyData.insert(from, edgesFrom);
-        }
-        {
-            auto edgesTo = AdjacencyData.get(to);
-            for (int i = 0; i < edgesTo.GetLength(); i++) {
-                if (edgesTo[i].GetNode() == from) {
-                    edgesTo.RemoveAt(i);
-                    break;
+        }
+        std::sort(entries.begin(), entries.end(), [](const BatchEntry& a, const BatchEntry& b) {
+            if (a.list != b.list) return a.list < b.list;
+            if (a.target < b.target) return true;
+            if (b.target < a.target) return false;
+            return a.sequence < b.sequence;
+        });
+
+        // in order, a Connect only counts if the edge is missing, so what survives is the first
+        // Connect after the last Disconnect
+        DynamicArray<BatchChange> changes(entries.GetLength());
+        DynamicArray<int> groupStart;
+        for (int i = 0; i < entries.GetLength();) {
+            BatchChange change{ entries[i].list, entries[i].target, false, false, WeightType(), false };
+            int j = i;
+            for (; j < entries.GetLength() && entries[j].list == change.list && entries[j].target == change.target; j++) {
+                if (!entries[j].connect) {
+                    change.removes = true;
+                    change.adds = false;
                 }
+                else if (!change.adds) {
+                    change.adds = true;
+                    change.weight = entries[j].weight;
+                }
+            }
+            if (changes.GetLength() == 0 || changes[changes.GetLength() - 1].list != change.list) {
+                groupStart.Append(changes.GetLength());
+            }
+            changes.Append(change);
+            i = j;
+        }
+        groupStart.Append(changes.GetLength());
+        int groupCount = groupStart.GetLength() - 1;
+
+        // write access (and copy-on-write) restructures the tables, so it is taken serially;
+        // the lists themselves are distinct and merged in parallel
+        DynamicArray<EdgeList*> lists(groupCount);
+        DynamicArray<bool> changed(groupCount);
+        for (int g = 0; g < groupCount; g++) {
+            int list = changes[groupStart[g]].list;
+            EdgeTable& table = list % 2 == 0 ? AdjacencyData : IncomingData;
+            lists.Append(table.find(Nodes[list / 2]));
+            changed.Append(false);
+        }
+        ParallelFor(0, groupCount, [&](int g) {
+            changed[g] = MergeEdges(*lists[g], changes, groupStart[g], groupStart[g + 1]);
+        });
+
+        bool anyChanged = false;
+        for (int g = 0; g < groupCount; g++) {
+            if (!changed[g])
+                continue;
+            anyChanged = true;
+            int list = changes[groupStart[g]].list;
+            IndexTable& indexes = list % 2 == 0 ? OutNeighborIndex : InNeighborIndex;
+            const TKey& owner = Nodes[list / 2];
+            if (lists[g]->GetLength() > HubDegreeThreshold || indexes.exist(owner)) {
+                RebuildNeighborIndex(indexes, owner, *lists[g]);
+            }
+        }
+        if (anyChanged) {
+            Version++;
+        }
+    }
+
+    // Moves vertex i of the node order to position newIndex[i] (newIndex must be a permutation)
+    // and sorts every edge list by the new positions of the neighbors
+    void Reorder(const DynamicArray<int>& newIndex) {
+        int numNodes = Nodes.GetLength();
+        if (newIndex.GetLength() != numNodes)
+            throw std::invalid_argument("Reorder: mapping size differs from the node count");
+        DynamicArray<TKey> reordered(numNodes);
+        DynamicArray<bool> used(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            reordered.Append(TKey());
+            used.Append(false);
+        }
+        for (int i = 0; i < numNodes; i++) {
+            int to = newIndex[i];
+            if (to < 0 || to >= numNodes || used[to])
+                throw std::invalid_argument("Reorder: mapping is not a permutation");
+            used[to] = true;
+            reordered[to] = Nodes[i];
+        }
+
+        Nodes.Clear();
+        for (int i = 0; i < numNodes; i++) {
+            Nodes.Append(reordered[i]);
+            NodeIndex.insert(Nodes[i], i);
+        }
+        for (int i = 0; i < numNodes; i++) {
+            SortEdges(AdjacencyData, OutNeighborIndex, Nodes[i]);
+            if constexpr (Direction::IsDirected) {
+                SortEdges(IncomingData, InNeighborIndex, Nodes[i]);
             }
-            AdjacencyData.insert(to, edgesTo);
         }
+        Version++;
     }
 
     void GenerateGraph(int nodeCount, int edgeCount, WeightType minWeight, WeightType maxWeight) {
@@ -169,16 +498,7 @@ public:
             if (a == b) continue;
             TKey from = Nodes[a];
             TKey to = Nodes[b];
-
-            auto edgesFrom = AdjacencyData.get(from);
-            bool exists = false;
-            for (int i = 0; i < edgesFrom.GetLength(); i++) {
-                if (edgesFrom[i].GetNode() == to) {
-                    exists = true;
-                    break;
-                }
-            }
-            if (exists) continue;
+            if (HasEdge(from, to)) continue;
 
             WeightType w = minWeight + (static_cast<WeightType>(std::rand()) / RAND_MAX) * (maxWeight - minWeight);
 
@@ -188,7 +508,12 @@ public:
     }
 
     void ClearGraph() {
+        Version++;
+        NodeIndex.Clear();
         AdjacencyData.Clear();
+        IncomingData.Clear();
+        OutNeighborIndex.Clear();
+        InNeighborIndex.Clear();
         Nodes.Clear();
     }
 
@@ -217,6 +542,10 @@ public:
         if (!outFile.is_open()) {
             throw std::runtime_error("Failed to open file for saving.");
         }
+        // enough digits for the weights to load back exactly
+        if constexpr (std::is_floating_point<WeightType>::value) {
+            outFile.precision(std::numeric_limits<WeightType>::max_digits10);
+        }
         outFile << Nodes.GetLength() << "\n";
         for (int i = 0; i < Nodes.GetLength(); i++) {
             outFile << KeyToString(Nodes[i]) << "\n";
@@ -226,6 +555,10 @@ public:
             if (AdjacencyData.exist(node)) {
                 auto edges = AdjacencyData.get(node);
                 for (int j = 0; j < edges.GetLength(); j++) {
+                    // an undirected edge is written once, from its smaller endpoint
+                    if constexpr (!Direction::IsDirected) {
+                        if (edges[j].GetNode() < node) continue;
+                    }
                     outFile << KeyToString(node)
                         << " " << KeyToString(edges[j].GetNode())
                         << " " << edges[j].GetWeight() << "\n";
@@ -259,6 +592,155 @@ public:
     }
 
 private:
+    static int FindEdgePosition(const EdgeTable& table, const IndexTable& indexes,
+        const TKey& owner, const TKey& target) {
+        const EdgeList* edges = table.find(owner);
+        if (!edges)
+            return -1;
+        if (edges->GetLength() > HubDegreeThreshold) {
+            const NeighborMap* index = indexes.find(owner);
+            if (index) {
+                const int* position = index->find(target);
+                return position ? *position : -1;
+            }
+        }
+        for (int i = 0; i < edges->GetLength(); i++) {
+            if ((*edges)[i].GetNode() == target)
+                return i;
+        }
+        return -1;
+    }
+
+    static void AppendEdge(EdgeTable& table, IndexTable& indexes,
+        const TKey& owner, const MyWeightedEdge<TKey, WeightType>& edge) {
+        EdgeList* edges = table.find(owner);
+        edges->Append(edge);
+        NeighborMap* index = indexes.find(owner);
+        if (index) {
+            index->insert(edge.GetNode(), edges->GetLength() - 1);
+        }
+        else if (edges->GetLength() > HubDegreeThreshold) {
+            RebuildNeighborIndex(indexes, owner, *edges);
+        }
+    }
+
+    static void RemoveEdge(EdgeTable& table, IndexTable& indexes,
+        const TKey& owner, const TKey& target) {
+        int position = FindEdgePosition(table, indexes, owner, target);
+        if (position == -1)
+            return;
+        EdgeList* edges = table.find(owner);
+        edges->SwapRemoveAt(position);
+        NeighborMap* index = indexes.find(owner);
+        if (index) {
+            index->remove(target);
+            if (position < edges->GetLength()) {
+                index->insert((*edges)[position].GetNode(), position);
+            }
+        }
+    }
+
+    // Index of the change for target among the sorted changes [begin, end), -1 if there is none
+    static int FindChange(const DynamicArray<BatchChange>& changes, int begin, int end, const TKey& target) {
+        int low = begin, high = end;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (changes[middle].target < target) low = middle + 1;
+            else high = middle;
+        }
+        return low < end && changes[low].target == target ? low : -1;
+    }
+
+    // Applies the changes [begin, end) to edges in one compacting pass; false if nothing changed.
+    // Kept edges stay in their order, new ones follow in neighbor order.
+    static bool MergeEdges(EdgeList& edges, DynamicArray<BatchChange>& changes, int begin, int end) {
+        bool changed = false;
+        int kept = 0;
+        for (int i = 0; i < edges.GetLength(); i++) {
+            int c = FindChange(changes, begin, end, edges[i].GetNode());
+            if (c != -1) {
+                changes[c].present = true;
+                if (changes[c].removes) {
+                    changed = true;
+                    if (!changes[c].adds)
+                        continue;
+                    edges[i].SetWeight(changes[c].weight);
+                }
+            }
+            edges[kept++] = edges[i];
+        }
+        edges.Truncate(kept);
+        for (int c = begin; c < end; c++) {
+            if (!changes[c].present && changes[c].adds) {
+                edges.Append(MyWeightedEdge<TKey, WeightType>(changes[c].target, changes[c].weight));
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    static void RebuildNeighborIndex(IndexTable& indexes, const TKey& owner, const EdgeList& edges) {
+        if (edges.GetLength() <= HubDegreeThreshold) {
+            indexes.remove(owner);
+            return;
+        }
+        NeighborMap index(edges.GetLength() * 2 + 11);
+        for (int i = 0; i < edges.GetLength(); i++) {
+            index.insert(edges[i].GetNode(), i);
+        }
+        indexes.insert(owner, index);
+    }
+
+    void SortEdges(EdgeTable& table, IndexTable& indexes, const TKey& owner) {
+        EdgeList& edges = *table.find(owner);
+        if (edges.GetLength() < 2)
+            return;
+        std::sort(edges.begin(), edges.end(),
+            [this](const MyWeightedEdge<TKey, WeightType>& a, const MyWeightedEdge<TKey, WeightType>& b) {
+                return *NodeIndex.find(a.GetNode()) < *NodeIndex.find(b.GetNode());
+            });
+        if (indexes.exist(owner)) {
+            RebuildNeighborIndex(indexes, owner, edges);
+        }
+    }
+
+    static void CollectUnmarked(const EdgeList& edges, const HashTable<TKey, bool>& marked,
+        HashTable<TKey, bool>& seen, DynamicArray<TKey>& result) {
+        for (int i = 0; i < edges.GetLength(); i++) {
+            TKey neighbor = edges[i].GetNode();
+            if (!marked.exist(neighbor) && !seen.exist(neighbor)) {
+                seen.insert(neighbor, true);
+                result.Append(neighbor);
+            }
+        }
+    }
+
+    static void CompactEdges(EdgeTable& table, IndexTable& indexes,
+        const TKey& owner, const HashTable<TKey, bool>& marked) {
+        EdgeList& edges = *table.find(owner);
+        int kept = 0;
+        for (int i = 0; i < edges.GetLength(); i++) {
+            if (!marked.exist(edges[i].GetNode())) {
+                edges[kept++] = edges[i];
+            }
+        }
+        edges.Truncate(kept);
+        if (indexes.exist(owner)) {
+            RebuildNeighborIndex(indexes, owner, edges);
+        }
+    }
+
+    void RemoveNodeSlot(const TKey& vertex) {
+        int index = FindNodeIndex(vertex);
+        int last = Nodes.GetLength() - 1;
+        if (index != last) {
+            Nodes.Set(index, Nodes[last]);
+            NodeIndex.insert(Nodes[index], index);
+        }
+        Nodes.RemoveLast();
+        NodeIndex.remove(vertex);
+    }
+
     std::string KeyToString(const TKey& key) const {
         if constexpr (std::is_same<TKey, std::string>::value) {
             return key;
@@ -0,0 +1,92 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Parallel.h"
+#include "UnionFind.h"
+
+// component[v] is a dense label in [0, GetCount()), sizes[label] the number of its vertices
+struct ComponentsResult {
+    DynamicArray<int> component;
+    DynamicArray<int> sizes;
+
+    int GetCount() const {
+        return sizes.GetLength();
+    }
+};
+
+// Connected components (weakly connected for directed graphs) with the Afforest scheme:
+// the first samplingRounds edges of every vertex are linked first, which usually reveals the
+// giant component; afterwards only vertices outside it need their remaining edges linked.
+template <typename TKey, typename WeightPolicy>
+ComponentsResult ConnectedComponents(const CsrGraph<TKey, WeightPolicy>& graph, int samplingRounds = 2)
+{
+    int numNodes = graph.GetNodeCount();
+    ConcurrentUnionFind sets(numNodes);
+
+    for (int r = 0; r < samplingRounds; r++) {
+        ParallelFor(0, numNodes, [&](int v) {
+            if (graph.GetDegree(v) > r) {
+                sets.Union(v, graph.GetTarget(graph.RowBegin(v) + r));
+            }
+        });
+    }
+    ParallelFor(0, numNodes, [&](int v) { sets.Compress(v); });
+
+    // the most frequent root among a few sampled vertices is taken as the giant component
+    int giant = -1;
+    if (numNodes > 0) {
+        const int samples = 1024;
+        HashTable<int, int> counts(2 * samples + 11);
+        int bestCount = 0;
+        unsigned int seed = 27491095u;
+        for (int i = 0; i < samples; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int root = sets.Find(static_cast<int>((seed >> 8) % static_cast<unsigned int>(numNodes)));
+            int* count = counts.find(root);
+            int value = count ? ++*count : 1;
+            if (!count) counts.insert(root, 1);
+            if (value > bestCount) {
+                bestCount = value;
+                giant = root;
+            }
+        }
+    }
+
+    ParallelFor(0, numNodes, [&](int v) {
+        if (sets.Find(v) == giant)
+            return;
+        for (int e = graph.RowBegin(v) + samplingRounds; e < graph.RowEnd(v); e++) {
+            sets.Union(v, graph.GetTarget(e));
+        }
+        // outgoing rows alone miss edges whose source sits in the giant component
+        if (graph.IsDirected()) {
+            for (int e = graph.InRowBegin(v); e < graph.InRowEnd(v); e++) {
+                sets.Union(v, graph.GetSource(e));
+            }
+        }
+    });
+    ParallelFor(0, numNodes, [&](int v) { sets.Compress(v); });
+
+    ComponentsResult result;
+    result.component = DynamicArray<int>(numNodes);
+    DynamicArray<int> labelOfRoot(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        labelOfRoot.Append(-1);
+    }
+    for (int v = 0; v < numNodes; v++) {
+        int root = sets.Find(v);
+        if (labelOfRoot[root] == -1) {
+            labelOfRoot[root] = result.sizes.GetLength();
+            result.sizes.Append(0);
+        }
+        result.component.Append(labelOfRoot[root]);
+        result.sizes[labelOfRoot[root]]++;
+    }
+    return result;
+}
+
+// Components of a Graph, indexed by its node order
+template <typename TKey, typename WeightType, typename Direction>
+ComponentsResult ConnectedComponents(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return ConnectedComponents(CsrGraph<TKey, ExactWeights<WeightType>>(graph));
+}
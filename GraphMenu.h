@@ -2,12 +2,13 @@
 #include "Graph.h"
 #include "GraphUtils.h"
 #include "TestSuite.h"
+#include "Benchmarks.h"
 #include <iostream>
 #include <string>
 #include <limits>
 
-template <typename TKey, typename WeightType>
-void GraphMenu(Graph<TKey, WeightType>& graph) {
+template <typename TKey, typename WeightType, typename Direction>
+void GraphMenu(Graph<TKey, WeightType, Direction>& graph) {
     bool exitFlag = false;
     while (!exitFlag)
     {
@@ -22,6 +23,7 @@ void GraphMenu(Graph<TKey, WeightType>& graph) {
             << "7. Calculate minimum distances (external function)\n"
             << "8. Print graph\n"
             << "9. Run tests\n"
+            << "10. Run benchmarks\n"
             << "0. Exit\n"
             << "Enter command: ";
 
@@ -156,6 +158,11 @@ void GraphMenu(Graph<TKey, WeightType>& graph) {
             RunAllTests(); 
             break;
         }
+        case 10:
+        {
+            RunAllBenchmarks();
+            break;
+        }
         case 0:
         {
             exitFlag = true;
@@ -0,0 +1,254 @@
+#pragma once
+#include "Bitmap.h"
+#include "CsrGraph.h"
+#include "Pair.h"
+#include "Parallel.h"
+
+// Hop distances (-1 for unreachable vertices) and BFS-tree parents (-1 for the source
+// and unreachable vertices), indexed by vertex id
+struct BfsResult {
+    DynamicArray<int> distance;
+    DynamicArray<int> parent;
+};
+
+inline BfsResult MakeBfsResult(int numNodes)
+{
+    BfsResult result;
+    result.distance = DynamicArray<int>(numNodes);
+    result.parent = DynamicArray<int>(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        result.distance.Append(-1);
+        result.parent.Append(-1);
+    }
+    return result;
+}
+
+// Serial top-down BFS on any graph with GetNodeCount and ForEachNeighbor(u, visit(v, weight)):
+// CompressedGraph and the graph views
+template <typename GraphType>
+BfsResult QueueBfs(const GraphType& graph, int source)
+{
+    int numNodes = graph.GetNodeCount();
+    BfsResult result = MakeBfsResult(numNodes);
+    if (source < 0 || source >= numNodes)
+        return result;
+
+    DynamicArray<int> queue(numNodes);
+    result.distance[source] = 0;
+    queue.Append(source);
+    for (int head = 0; head < queue.GetLength(); head++) {
+        int u = queue[head];
+        graph.ForEachNeighbor(u, [&](int v, auto) {
+            if (result.distance[v] == -1) {
+                result.distance[v] = result.distance[u] + 1;
+                result.parent[v] = u;
+                queue.Append(v);
+            }
+        });
+    }
+    return result;
+}
+
+namespace BfsDetail {
+
+    // Expands the frontier queue along outgoing edges; returns the out-degree sum of the new frontier
+    template <typename TKey, typename WeightPolicy>
+    long long TopDownStep(const CsrGraph<TKey, WeightPolicy>& graph, BfsResult& result, Bitmap& visited,
+        DynamicArray<int>& frontier)
+    {
+        int threads = GetThreadCount();
+        DynamicArray<DynamicArray<int>> localNext(threads);
+        DynamicArray<long long> localScout(threads);
+        for (int t = 0; t < threads; t++) {
+            localNext.Append(DynamicArray<int>());
+            localScout.Append(0);
+        }
+
+        ParallelForBlocks(0, frontier.GetLength(), [&](int blockBegin, int blockEnd, int worker) {
+            DynamicArray<int>& next = localNext[worker];
+            long long scout = 0;
+            for (int i = blockBegin; i < blockEnd; i++) {
+                int u = frontier[i];
+                for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                    int v = graph.GetTarget(e);
+                    if (!visited.TestAndSet(v)) {
+                        result.parent[v] = u;
+                        result.distance[v] = result.distance[u] + 1;
+                        next.Append(v);
+                        scout += graph.GetDegree(v);
+                    }
+                }
+            }
+            localScout[worker] += scout;
+        });
+
+        frontier.Truncate(0);
+        long long scout = 0;
+        for (int t = 0; t < threads; t++) {
+            for (int i = 0; i < localNext[t].GetLength(); i++) {
+                frontier.Append(localNext[t][i]);
+            }
+            scout += localScout[t];
+        }
+        return scout;
+    }
+
+    // Every unvisited vertex looks for a parent in the current frontier; returns the size of the next frontier
+    template <typename TKey, typename WeightPolicy>
+    int BottomUpStep(const CsrGraph<TKey, WeightPolicy>& graph, BfsResult& result, Bitmap& visited,
+        const Bitmap& front, Bitmap& next)
+    {
+        int threads = GetThreadCount();
+        DynamicArray<int> localAwake(threads);
+        for (int t = 0; t < threads; t++) {
+            localAwake.Append(0);
+        }
+        next.Clear();
+
+        ParallelForBlocks(0, graph.GetNodeCount(), [&](int blockBegin, int blockEnd, int worker) {
+            int awake = 0;
+            for (int v = blockBegin; v < blockEnd; v++) {
+                if (visited.Get(v))
+                    continue;
+                for (int e = graph.InRowBegin(v); e < graph.InRowEnd(v); e++) {
+                    int u = graph.GetSource(e);
+                    if (front.Get(u)) {
+                        visited.Set(v);
+                        result.parent[v] = u;
+                        result.distance[v] = result.distance[u] + 1;
+                        next.Set(v);
+                        awake++;
+                        break;
+                    }
+                }
+            }
+            localAwake[worker] += awake;
+        });
+
+        int awake = 0;
+        for (int t = 0; t < threads; t++) {
+            awake += localAwake[t];
+        }
+        return awake;
+    }
+
+}
+
+// Direction-optimizing BFS (Beamer et al.): top-down steps over a frontier queue switch to
+// bottom-up steps over bitmap frontiers while the frontier covers a large part of the edges.
+// alpha and beta are the switching thresholds of the heuristic.
+template <typename TKey, typename WeightPolicy>
+BfsResult BreadthFirstSearch(const CsrGraph<TKey, WeightPolicy>& graph, int source,
+    double alpha = 14.0, double beta = 24.0)
+{
+    int numNodes = graph.GetNodeCount();
+    BfsResult result = MakeBfsResult(numNodes);
+    if (source < 0 || source >= numNodes) {
+        return result;
+    }
+
+    Bitmap visited(numNodes);
+    visited.Set(source);
+    result.distance[source] = 0;
+    DynamicArray<int> frontier;
+    frontier.Append(source);
+
+    long long edgesToCheck = graph.GetEdgeCount();
+    long long scoutCount = graph.GetDegree(source);
+    while (frontier.GetLength() > 0) {
+        if (scoutCount > edgesToCheck / alpha) {
+            Bitmap front(numNodes);
+            Bitmap next(numNodes);
+            for (int i = 0; i < frontier.GetLength(); i++) {
+                front.Set(frontier[i]);
+            }
+            int awake = frontier.GetLength();
+            int oldAwake;
+            do {
+                oldAwake = awake;
+                awake = BfsDetail::BottomUpStep(graph, result, visited, front, next);
+                front.Swap(next);
+            } while (awake > 0 && (awake >= oldAwake || awake > numNodes / beta));
+
+            frontier.Truncate(0);
+            for (int v = 0; v < numNodes; v++) {
+                if (front.Get(v)) {
+                    frontier.Append(v);
+                }
+            }
+            scoutCount = 1;
+        }
+        else {
+            edgesToCheck -= scoutCount;
+            scoutCount = BfsDetail::TopDownStep(graph, result, visited, frontier);
+        }
+    }
+    return result;
+}
+
+// BFS by key on a Graph; the result is indexed by the node order of the graph
+template <typename TKey, typename WeightType, typename Direction>
+BfsResult BreadthFirstSearch(const Graph<TKey, WeightType, Direction>& graph, const TKey& source)
+{
+    CsrGraph<TKey, ExactWeights<WeightType>> csr(graph);
+    return BreadthFirstSearch(csr, csr.FindNodeIndex(source));
+}
+
+// Preorder depth-first traversal with an explicit stack instead of recursion:
+//   for (DepthFirstIterator<TKey, P> it(csr, source); !it.IsEnd(); ++it) { int v = *it; ... }
+template <typename TKey, typename WeightPolicy>
+class DepthFirstIterator {
+private:
+    const CsrGraph<TKey, WeightPolicy>& graph;
+    DynamicArray<bool> visited;
+    // vertex and the position of its next unexplored edge
+    DynamicArray<Pair<int, int>> stack;
+    int current;
+
+    void Enter(int vertex) {
+        visited[vertex] = true;
+        stack.Append(Pair<int, int>(vertex, graph.RowBegin(vertex)));
+        current = vertex;
+    }
+
+public:
+    DepthFirstIterator(const CsrGraph<TKey, WeightPolicy>& graph, int source)
+        : graph(graph), visited(graph.GetNodeCount()), stack(), current(-1) {
+        for (int i = 0; i < graph.GetNodeCount(); i++) {
+            visited.Append(false);
+        }
+        if (source >= 0 && source < graph.GetNodeCount()) {
+            Enter(source);
+        }
+    }
+
+    bool IsEnd() const {
+        return current == -1;
+    }
+
+    int operator*() const {
+        return current;
+    }
+
+    // Depth of the current vertex in the DFS tree
+    int GetDepth() const {
+        return stack.GetLength() - 1;
+    }
+
+    DepthFirstIterator& operator++() {
+        while (stack.GetLength() > 0) {
+            Pair<int, int>& top = stack.GetLastElem();
+            if (top.value == graph.RowEnd(top.key)) {
+                stack.Truncate(stack.GetLength() - 1);
+                continue;
+            }
+            int next = graph.GetTarget(top.value++);
+            if (!visited[next]) {
+                Enter(next);
+                return *this;
+            }
+        }
+        current = -1;
+        return *this;
+    }
+};
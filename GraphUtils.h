@@ -1,10 +1,14 @@
 #pragma once
 #include "Graph.h"
+#include "CsrGraph.h"
+#include "BinaryHeap.h"
+#include "Pair.h"
 #include <limits>
 #include <stdexcept>
+#include <type_traits>
 
-template <typename TKey, typename WeightType>
-DynamicArray<int> GraphColoring(const Graph<TKey, WeightType>& graph)
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<int> GraphColoring(const Graph<TKey, WeightType, Direction>& graph)
 {
     int numNodes = graph.GetNodeCount();
     DynamicArray<int> colors;
@@ -36,6 +40,15 @@ DynamicArray<int> GraphColoring(const Graph<TKey, WeightType>& graph)
                 available[colors[neighborIndex]] = false;
             }
         }
+        if constexpr (Direction::IsDirected) {
+            auto incoming = graph.GetIncomingVertices(currentNode);
+            for (int idx = 0; idx < incoming.GetLength(); idx++) {
+                int neighborIndex = graph.FindNodeIndex(incoming[idx].GetNode());
+                if (neighborIndex != -1 && colors[neighborIndex] != -1) {
+                    available[colors[neighborIndex]] = false;
+                }
+            }
+        }
 
         //    
         int c;
@@ -50,8 +63,50 @@ DynamicArray<int> GraphColoring(const Graph<TKey, WeightType>& graph)
     return colors;
 }
 
-template <typename TKey>
-DynamicArray<TKey> ReconstructPath(int endIndex, const DynamicArray<int>& predecessors, const Graph<TKey>& graph)
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> GraphColoring(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> colors;
+    colors.Reserve(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        colors.Append(-1);
+    }
+
+    // forbidden[c] == i means that color c is already used by a neighbor of vertex i
+    DynamicArray<int> forbidden;
+    forbidden.Reserve(numNodes + 1);
+    for (int i = 0; i <= numNodes; i++) {
+        forbidden.Append(-1);
+    }
+
+    for (int i = 0; i < numNodes; i++) {
+        for (int e = graph.RowBegin(i); e < graph.RowEnd(i); e++) {
+            int neighborColor = colors[graph.GetTarget(e)];
+            if (neighborColor != -1) {
+                forbidden[neighborColor] = i;
+            }
+        }
+        if (graph.IsDirected()) {
+            for (int e = graph.InRowBegin(i); e < graph.InRowEnd(i); e++) {
+                int neighborColor = colors[graph.GetSource(e)];
+                if (neighborColor != -1) {
+                    forbidden[neighborColor] = i;
+                }
+            }
+        }
+        int c = 0;
+        while (forbidden[c] == i) {
+            c++;
+        }
+        colors[i] = c;
+    }
+
+    return colors;
+}
+
+template <typename TKey, typename GraphType>
+DynamicArray<TKey> ReconstructPath(int endIndex, const DynamicArray<int>& predecessors, const GraphType& graph)
 {
     DynamicArray<TKey> path;
     int current = endIndex;
@@ -67,9 +122,158 @@ DynamicArray<TKey> ReconstructPath(int endIndex, const DynamicArray<int>& predec
     return reversedPath;
 }
 
-template <typename TKey, typename WeightType>
-DynamicArray<PathInfo<TKey>> MinDistances(const Graph<TKey, WeightType>& graph, const TKey& startNode)
+// Distances (-1 for unreachable vertices) and shortest-path predecessors (-1 for the source
+// and unreachable vertices), indexed by vertex id. Weights are truncated to int as in MinDistances.
+struct SsspResult {
+    DynamicArray<int> distance;
+    DynamicArray<int> predecessor;
+};
+
+// Converts an SsspResult into the format returned by MinDistances
+template <typename TKey, typename GraphType>
+DynamicArray<PathInfo<TKey>> ToPathInfos(const GraphType& graph, const SsspResult& sssp)
+{
+    int numNodes = sssp.distance.GetLength();
+    DynamicArray<PathInfo<TKey>> result;
+    result.Reserve(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        PathInfo<TKey> pi;
+        pi.distance = sssp.distance[i];
+        if (pi.distance != -1) {
+            pi.path = ReconstructPath<TKey>(i, sssp.predecessor, graph);
+        }
+        result.Append(pi);
+    }
+    return result;
+}
+
+inline SsspResult MakeSsspResult(int numNodes)
+{
+    SsspResult result;
+    result.distance = DynamicArray<int>(numNodes);
+    result.predecessor = DynamicArray<int>(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        result.distance.Append(-1);
+        result.predecessor.Append(-1);
+    }
+    return result;
+}
+
+// Dijkstra with a binary heap, O((V + E) log V), on any graph with GetNodeCount and
+// ForEachNeighbor(u, visit(v, weight)): CsrGraph, CompressedGraph and the graph views.
+// Throws std::invalid_argument when it reaches a negative edge.
+template <typename GraphType>
+SsspResult HeapDijkstra(const GraphType& graph, int source)
+{
+    SsspResult result = MakeSsspResult(graph.GetNodeCount());
+    if (source < 0 || source >= graph.GetNodeCount())
+        return result;
+
+    BinaryHeap<Pair<int, int>> heap;
+    result.distance[source] = 0;
+    heap.Push(Pair<int, int>(0, source));
+    while (!heap.IsEmpty()) {
+        Pair<int, int> top = heap.Pop();
+        int u = top.value;
+        if (top.key != result.distance[u])
+            continue;
+        graph.ForEachNeighbor(u, [&](int v, auto w) {
+            // a negative edge could lower a settled vertex, and an undirected one is a negative cycle
+            if (w < 0)
+                throw std::invalid_argument("HeapDijkstra: negative edge weight");
+            int newDist = top.key + static_cast<int>(w);
+            if (result.distance[v] == -1 || newDist < result.distance[v]) {
+                result.distance[v] = newDist;
+                result.predecessor[v] = u;
+                heap.Push(Pair<int, int>(newDist, v));
+            }
+        });
+    }
+    return result;
+}
+
+template <typename TKey, typename WeightPolicy>
+SsspResult DijkstraDistances(const CsrGraph<TKey, WeightPolicy>& graph, int source)
+{
+    return HeapDijkstra(graph, source);
+}
+
+// Largest edge weight Dial's algorithm accepts; its bucket ring has maxWeight + 1 slots
+constexpr int DialMaxWeight = 1 << 16;
+
+// Dial's algorithm for small non-negative integer weights: a ring of maxWeight + 1 buckets
+// replaces the comparison heap, O(E + V * maxWeight) in the worst case, usually close to O(E).
+template <typename TKey, typename WeightPolicy>
+SsspResult DialDistances(const CsrGraph<TKey, WeightPolicy>& graph, int source)
+{
+    int numNodes = graph.GetNodeCount();
+    SsspResult result = MakeSsspResult(numNodes);
+    if (source < 0 || source >= numNodes)
+        return result;
+
+    int maxWeight = 0;
+    for (int e = 0; e < graph.GetEdgeCount(); e++) {
+        int w = static_cast<int>(graph.GetWeight(e));
+        if (w < 0) throw std::invalid_argument("DialDistances: negative edge weight");
+        if (w > maxWeight) maxWeight = w;
+    }
+    if (maxWeight > DialMaxWeight) throw std::invalid_argument("DialDistances: edge weight too large");
+
+    int ringSize = maxWeight + 1;
+    DynamicArray<DynamicArray<int>> ring(ringSize);
+    for (int i = 0; i < ringSize; i++) {
+        ring.Append(DynamicArray<int>());
+    }
+
+    result.distance[source] = 0;
+    ring[0].Append(source);
+    int pending = 1;
+    for (int current = 0; pending > 0; current++) {
+        DynamicArray<int>& bucket = ring[current % ringSize];
+        while (bucket.GetLength() > 0) {
+            int u = bucket.GetLastElem();
+            bucket.Truncate(bucket.GetLength() - 1);
+            pending--;
+            if (result.distance[u] != current)
+                continue;
+            for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                int v = graph.GetTarget(e);
+                int newDist = current + static_cast<int>(graph.GetWeight(e));
+                if (result.distance[v] == -1 || newDist < result.distance[v]) {
+                    result.distance[v] = newDist;
+                    result.predecessor[v] = u;
+                    ring[newDist % ringSize].Append(v);
+                    pending++;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Integer weights in [0, DialMaxWeight] go to Dial's algorithm, other weights to the heap
+template <typename TKey, typename WeightPolicy>
+bool FitsDial(const CsrGraph<TKey, WeightPolicy>& graph)
 {
+    for (int e = 0; e < graph.GetEdgeCount(); e++) {
+        auto w = graph.GetWeight(e);
+        if (w < 0 || w > DialMaxWeight)
+            return false;
+    }
+    return true;
+}
+
+// Integral weight types are dispatched at compile time to Dial's algorithm (or a binary heap
+// when the weights are out of its range); floating-point weights keep the general path.
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<PathInfo<TKey>> MinDistances(const Graph<TKey, WeightType, Direction>& graph, const TKey& startNode)
+{
+    if constexpr (std::is_integral<WeightType>::value) {
+        CsrGraph<TKey, ExactWeights<WeightType>> csr(graph);
+        int source = csr.FindNodeIndex(startNode);
+        return ToPathInfos<TKey>(graph, FitsDial(csr) ? DialDistances(csr, source) : DijkstraDistances(csr, source));
+    }
+
     int numNodes = graph.GetNodeCount();
     DynamicArray<int> dist;
     dist.Reserve(numNodes);
@@ -123,6 +327,9 @@ DynamicArray<PathInfo<TKey>> MinDistances(const Graph<TKey, WeightType>& graph,
         for (int e = 0; e < neighbors.GetLength(); e++) {
             TKey neighbor = neighbors[e].GetNode();
             WeightType w = neighbors[e].GetWeight();
+            // a visited vertex would be lowered again and its path could loop
+            if (w < 0)
+                throw std::invalid_argument("MinDistances: negative edge weight");
             int neighborIdx = graph.FindNodeIndex(neighbor);
             if (neighborIdx == -1) continue;
 
@@ -143,7 +350,7 @@ DynamicArray<PathInfo<TKey>> MinDistances(const Graph<TKey, WeightType>& graph,
         PathInfo<TKey> pi;
         if (dist[i] != std::numeric_limits<int>::max()) {
             pi.distance = dist[i];
-            pi.path = ReconstructPath(i, predecessors, graph);
+            pi.path = ReconstructPath<TKey>(i, predecessors, graph);
         }
         else {
             pi.distance = -1;
@@ -151,4 +358,73 @@ DynamicArray<PathInfo<TKey>> MinDistances(const Graph<TKey, WeightType>& graph,
         result.Append(pi);
     }
     return result;
-}
\ No newline at end of file
+}
+
+template <typename TKey, typename WeightPolicy>
+DynamicArray<PathInfo<TKey>> MinDistances(const CsrGraph<TKey, WeightPolicy>& graph, const TKey& startNode)
+{
+    if constexpr (std::is_integral<typename WeightPolicy::ValueType>::value) {
+        int source = graph.FindNodeIndex(startNode);
+        return ToPathInfos<TKey>(graph, FitsDial(graph) ? DialDistances(graph, source) : DijkstraDistances(graph, source));
+    }
+
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> dist;
+    DynamicArray<int> predecessors;
+    DynamicArray<bool> visited;
+    dist.Reserve(numNodes);
+    predecessors.Reserve(numNodes);
+    visited.Reserve(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        dist.Append(std::numeric_limits<int>::max());
+        predecessors.Append(-1);
+        visited.Append(false);
+    }
+
+    int startIndex = graph.FindNodeIndex(startNode);
+    if (startIndex != -1) {
+        dist[startIndex] = 0;
+    }
+
+    for (int step = 0; startIndex != -1 && step < numNodes; step++) {
+        int minDist = std::numeric_limits<int>::max();
+        int minIndex = -1;
+        for (int i = 0; i < numNodes; i++) {
+            if (!visited[i] && dist[i] < minDist) {
+                minDist = dist[i];
+                minIndex = i;
+            }
+        }
+
+        if (minIndex == -1)
+            break;
+
+        visited[minIndex] = true;
+
+        for (int e = graph.RowBegin(minIndex); e < graph.RowEnd(minIndex); e++) {
+            int neighborIdx = graph.GetTarget(e);
+            if (graph.GetWeight(e) < 0)
+                throw std::invalid_argument("MinDistances: negative edge weight");
+            int newDist = dist[minIndex] + static_cast<int>(graph.GetWeight(e));
+            if (newDist < dist[neighborIdx]) {
+                dist[neighborIdx] = newDist;
+                predecessors[neighborIdx] = minIndex;
+            }
+        }
+    }
+
+    DynamicArray<PathInfo<TKey>> result;
+    result.Reserve(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        PathInfo<TKey> pi;
+        if (dist[i] != std::numeric_limits<int>::max()) {
+            pi.distance = dist[i];
+            pi.path = ReconstructPath<TKey>(i, predecessors, graph);
+        }
+        else {
+            pi.distance = -1;
+        }
+        result.Append(pi);
+    }
+    return result;
+}
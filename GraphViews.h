@@ -0,0 +1,267 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Graph.h"
+#include "GraphTraversal.h"
+#include "GraphUtils.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Zero-copy views for the algorithms at the end of this file. A view keeps the vertex ids of the
+// graph it is taken from and hides vertices and edges on the fly while the adjacency is read;
+// nothing is copied, so the graph (and a vertex mask) must outlive the view.
+// Views are taken of a CsrGraph, of a Graph (one index lookup per visited edge) or of another view:
+//   auto light = FilterEdges(MaskVertices(csr, mask), [](int, int, double w) { return w < 5.0; });
+//   DynamicArray<PathInfo<int>> paths = MinDistances(light, start);
+// A view provides GetNodeCount, GetVertex, FindNodeIndex, IsDirected, Contains(v),
+// ForEachNeighbor(v, visit(target, weight)) and ForEachInNeighbor(v, visit(source, weight)).
+
+// Base of all views; the algorithms take a GraphView and work on the derived view
+template <typename View>
+class GraphView {
+public:
+    const View& Self() const {
+        return static_cast<const View&>(*this);
+    }
+};
+
+// All vertices and edges of a CsrGraph or a Graph
+template <typename GraphType>
+class WholeGraphView : public GraphView<WholeGraphView<GraphType>> {
+private:
+    const GraphType& graph;
+
+public:
+    using KeyType = typename std::decay<decltype(std::declval<const GraphType&>().GetVertex(0))>::type;
+
+    explicit WholeGraphView(const GraphType& graph) : graph(graph) {}
+
+    int GetNodeCount() const {
+        return graph.GetNodeCount();
+    }
+
+    KeyType GetVertex(int index) const {
+        return graph.GetVertex(index);
+    }
+
+    int FindNodeIndex(const KeyType& node) const {
+        return graph.FindNodeIndex(node);
+    }
+
+    bool IsDirected() const {
+        return graph.IsDirected();
+    }
+
+    bool Contains(int) const {
+        return true;
+    }
+
+    template <typename Visit>
+    void ForEachNeighbor(int v, Visit visit) const {
+        graph.ForEachNeighbor(v, visit);
+    }
+
+    template <typename Visit>
+    void ForEachInNeighbor(int v, Visit visit) const {
+        graph.ForEachInNeighbor(v, visit);
+    }
+};
+
+// Induced subgraph of the vertices v with mask[v] set; the mask is indexed by vertex id
+template <typename Parent>
+class VertexMaskView : public GraphView<VertexMaskView<Parent>> {
+private:
+    Parent parent;
+    const DynamicArray<bool>& mask;
+
+public:
+    using KeyType = typename Parent::KeyType;
+
+    VertexMaskView(const Parent& parent, const DynamicArray<bool>& mask) : parent(parent), mask(mask) {
+        if (mask.GetLength() != parent.GetNodeCount())
+            throw std::invalid_argument("VertexMaskView: mask size differs from the node count");
+    }
+
+    int GetNodeCount() const {
+        return parent.GetNodeCount();
+    }
+
+    KeyType GetVertex(int index) const {
+        return parent.GetVertex(index);
+    }
+
+    int FindNodeIndex(const KeyType& node) const {
+        return parent.FindNodeIndex(node);
+    }
+
+    bool IsDirected() const {
+        return parent.IsDirected();
+    }
+
+    bool Contains(int v) const {
+        return mask[v] && parent.Contains(v);
+    }
+
+    template <typename Visit>
+    void ForEachNeighbor(int v, Visit visit) const {
+        if (!mask[v])
+            return;
+        parent.ForEachNeighbor(v, [&](int target, auto weight) {
+            if (mask[target]) visit(target, weight);
+        });
+    }
+
+    template <typename Visit>
+    void ForEachInNeighbor(int v, Visit visit) const {
+        if (!mask[v])
+            return;
+        parent.ForEachInNeighbor(v, [&](int source, auto weight) {
+            if (mask[source]) visit(source, weight);
+        });
+    }
+};
+
+// Edges for which predicate(from, to, weight) holds. An undirected edge is seen from both ends,
+// as (u, v) and as (v, u), so the predicate should not depend on the order of the ends.
+template <typename Parent, typename Predicate>
+class EdgeFilterView : public GraphView<EdgeFilterView<Parent, Predicate>> {
+private:
+    Parent parent;
+    Predicate predicate;
+
+public:
+    using KeyType = typename Parent::KeyType;
+
+    EdgeFilterView(const Parent& parent, Predicate predicate) : parent(parent), predicate(predicate) {}
+
+    int GetNodeCount() const {
+        return parent.GetNodeCount();
+    }
+
+    KeyType GetVertex(int index) const {
+        return parent.GetVertex(index);
+    }
+
+    int FindNodeIndex(const KeyType& node) const {
+        return parent.FindNodeIndex(node);
+    }
+
+    bool IsDirected() const {
+        return parent.IsDirected();
+    }
+
+    bool Contains(int v) const {
+        return parent.Contains(v);
+    }
+
+    template <typename Visit>
+    void ForEachNeighbor(int v, Visit visit) const {
+        parent.ForEachNeighbor(v, [&](int target, auto weight) {
+            if (predicate(v, target, weight)) visit(target, weight);
+        });
+    }
+
+    template <typename Visit>
+    void ForEachInNeighbor(int v, Visit visit) const {
+        parent.ForEachInNeighbor(v, [&](int source, auto weight) {
+            if (predicate(source, v, weight)) visit(source, weight);
+        });
+    }
+};
+
+template <typename TKey, typename WeightPolicy>
+WholeGraphView<CsrGraph<TKey, WeightPolicy>> ViewOf(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    return WholeGraphView<CsrGraph<TKey, WeightPolicy>>(graph);
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+WholeGraphView<Graph<TKey, WeightType, Direction>> ViewOf(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return WholeGraphView<Graph<TKey, WeightType, Direction>>(graph);
+}
+
+template <typename View>
+View ViewOf(const GraphView<View>& view)
+{
+    return view.Self();
+}
+
+template <typename GraphType>
+auto MaskVertices(const GraphType& graph, const DynamicArray<bool>& mask)
+{
+    using Parent = decltype(ViewOf(graph));
+    return VertexMaskView<Parent>(ViewOf(graph), mask);
+}
+
+template <typename GraphType, typename Predicate>
+auto FilterEdges(const GraphType& graph, Predicate predicate)
+{
+    using Parent = decltype(ViewOf(graph));
+    return EdgeFilterView<Parent, Predicate>(ViewOf(graph), predicate);
+}
+
+// Algorithms on views. Results are indexed by vertex id; hidden vertices are never reached.
+
+// BFS over outgoing edges; hidden vertices and a hidden source keep distance -1
+template <typename View>
+BfsResult BreadthFirstSearch(const GraphView<View>& view, int source)
+{
+    const View& graph = view.Self();
+    if (source >= 0 && source < graph.GetNodeCount() && !graph.Contains(source))
+        return MakeBfsResult(graph.GetNodeCount());
+    return QueueBfs(graph, source);
+}
+
+// Binary-heap Dijkstra over outgoing edges
+template <typename View>
+SsspResult DijkstraDistances(const GraphView<View>& view, int source)
+{
+    const View& graph = view.Self();
+    if (source >= 0 && source < graph.GetNodeCount() && !graph.Contains(source))
+        return MakeSsspResult(graph.GetNodeCount());
+    return HeapDijkstra(graph, source);
+}
+
+template <typename View>
+DynamicArray<PathInfo<typename View::KeyType>> MinDistances(const GraphView<View>& view,
+    const typename View::KeyType& startNode)
+{
+    const View& graph = view.Self();
+    return ToPathInfos<typename View::KeyType>(graph, DijkstraDistances(view, graph.FindNodeIndex(startNode)));
+}
+
+// Greedy coloring in id order like the CsrGraph version; hidden vertices get color -1
+template <typename View>
+DynamicArray<int> GraphColoring(const GraphView<View>& view)
+{
+    const View& graph = view.Self();
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> colors(numNodes);
+    DynamicArray<int> forbidden(numNodes + 1);
+    for (int i = 0; i < numNodes; i++) {
+        colors.Append(-1);
+        forbidden.Append(-1);
+    }
+    forbidden.Append(-1);
+
+    auto forbid = [&](int i) {
+        return [&colors, &forbidden, i](int neighbor, auto) {
+            if (colors[neighbor] != -1) forbidden[colors[neighbor]] = i;
+        };
+    };
+    for (int i = 0; i < numNodes; i++) {
+        if (!graph.Contains(i))
+            continue;
+        graph.ForEachNeighbor(i, forbid(i));
+        if (graph.IsDirected()) {
+            graph.ForEachInNeighbor(i, forbid(i));
+        }
+        int c = 0;
+        while (forbidden[c] == i) {
+            c++;
+        }
+        colors[i] = c;
+    }
+    return colors;
+}
@@ -51,14 +51,28 @@ private:
         return 7;
     }
 
+    // Prime capacities keep every probe step coprime with the capacity,
+    // so a probe sequence visits every slot
+    int nextPrime(int n) const {
+        if (n <= 5) return 5;
+        while (true) {
+            bool isPrime = true;
+            for (int i = 2; i * i <= n; ++i) {
+                if (n % i == 0) {
+                    isPrime = false;
+                    break;
+                }
+            }
+            if (isPrime) return n;
+            n++;
+        }
+    }
+
     void rehash() {
         int oldCapacity = capacity;
         HashEntry<Key, Value>* oldTable = table;
 
-        capacity = oldCapacity * 2;
-        if (capacity <= 0) {
-            capacity = 1;
-        }
+        capacity = nextPrime(oldCapacity * 2);
         R = previousPrime(capacity / 2);
 
         table = new HashEntry<Key, Value>[capacity];
@@ -78,9 +92,7 @@ private:
 public:
     HashTable(int initialCapacity = 11, double loadFactor = 0.7)
         : capacity(initialCapacity), count(0), loadFactor(loadFactor), hashFunc(HashFunc()) {
-        if (capacity <= 0) {
-            capacity = 1;
-        }
+        capacity = nextPrime(capacity);
         table = new HashEntry<Key, Value>[capacity];
         for (int i = 0; i < capacity; ++i) {
             table[i].status = EntryStatus::EMPTY;
@@ -190,6 +202,27 @@ public:
         throw std::runtime_error("Key not found in HashTable.");
     }
 
+    // Pointer to the stored value for in-place updates, nullptr if the key is absent.
+    // The pointer stays valid until the next insert (which may rehash).
+    Value* find(const Key& key) {
+        return const_cast<Value*>(static_cast<const HashTable*>(this)->find(key));
+    }
+
+    const Value* find(const Key& key) const {
+        size_t hash1 = hashFunc(key) % capacity;
+        size_t hash2 = secondHash(key);
+        for (int i = 0; i < capacity; i++) {
+            size_t index = (hash1 + i * hash2) % capacity;
+            if (table[index].status == EntryStatus::EMPTY) {
+                return nullptr;
+            }
+            else if (table[index].status == EntryStatus::OCCUPIED && table[index].pair.key == key) {
+                return &table[index].pair.value;
+            }
+        }
+        return nullptr;
+    }
+
     bool remove(const Key& key) override {
         size_t hash1 = hashFunc(key) % capacity;
         size_t hash2 = secondHash(key);
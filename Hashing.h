@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+// Hash functions behind DefaultHash: a 64-bit finalizer for integers and a multiply-based
+// byte hash in the style of wyhash for strings, with an optional process-wide seed.
+
+// Seed used by hashers created from now on; 0 (the default) keeps hashes reproducible.
+// Tables keep the seed of their hasher, so changing it does not disturb existing tables.
+inline uint64_t& HashSeedSetting() {
+    static uint64_t seed = 0;
+    return seed;
+}
+
+inline void SetHashSeed(uint64_t seed) {
+    HashSeedSetting() = seed;
+}
+
+inline uint64_t GetHashSeed() {
+    return HashSeedSetting();
+}
+
+// Random seed against adversarial keys: collisions can no longer be precomputed
+inline void RandomizeHashSeed() {
+    std::random_device device;
+    SetHashSeed((static_cast<uint64_t>(device()) << 32) ^ device());
+}
+
+// Finalizer of MurmurHash3 (fmix64): every input bit affects every output bit
+inline uint64_t MixHash(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// Order-dependent combination, so that (a, b) and (b, a) hash differently
+inline uint64_t CombineHashes(uint64_t first, uint64_t second) {
+    return MixHash(first ^ (MixHash(second) + 0x9E3779B97F4A7C15ull));
+}
+
+namespace HashingDetail {
+
+    constexpr uint64_t Prime0 = 0xA0761D6478BD642Full;
+    constexpr uint64_t Prime1 = 0xE7037ED1A0B428DBull;
+    constexpr uint64_t Prime2 = 0x8EBC6AF09C88C6E3ull;
+    constexpr uint64_t Prime3 = 0x589965CC75374CC3ull;
+
+    // Full 64 x 64 -> 128 bit product, returned as low and high halves
+    inline void Multiply128(uint64_t& low, uint64_t& high) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(low) * high;
+        low = static_cast<uint64_t>(product);
+        high = static_cast<uint64_t>(product >> 64);
+#else
+        uint64_t aHigh = low >> 32, aLow = low & 0xFFFFFFFFull;
+        uint64_t bHigh = high >> 32, bLow = high & 0xFFFFFFFFull;
+        uint64_t ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+        uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull);
+        low = (ll & 0xFFFFFFFFull) | (middle << 32);
+        high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+    }
+
+    // Folded product of two words: the mixing step of the byte hash
+    inline uint64_t Mum(uint64_t a, uint64_t b) {
+        Multiply128(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t Read64(const uint8_t* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t Read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+}
+
+// Byte hash in the style of wyhash: keys up to 16 bytes take a single multiply, longer keys
+// are consumed 48 bytes at a time in three independent multiply lanes. Native byte order,
+// so hashes are not portable between little- and big-endian machines.
+inline uint64_t HashBytes(const void* data, size_t length, uint64_t seed = 0) {
+    using namespace HashingDetail;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed ^= Prime0;
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            size_t shift = (length >> 3) << 2;
+            a = (Read32(p) << 32) | Read32(p + shift);
+            b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - shift);
+        }
+        else if (length > 0) {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t left = length;
+        if (left > 48) {
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = Mum(Read64(p) ^ Prime1, Read64(p + 8) ^ seed);
+                lane1 = Mum(Read64(p + 16) ^ Prime2, Read64(p + 24) ^ lane1);
+                lane2 = Mum(Read64(p + 32) ^ Prime3, Read64(p + 40) ^ lane2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (left > 16) {
+            seed = Mum(Read64(p) ^ Prime1, Read64(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        // the last 16 bytes of the key, overlapping the ones already read
+        a = Read64(p + left - 16);
+        b = Read64(p + left - 8);
+    }
+    a ^= Prime1;
+    b ^= seed;
+    Multiply128(a, b);
+    return Mum(a ^ Prime0 ^ length, b ^ Prime1);
+}
@@ -1,5 +1,25 @@
 #include "Interface.h"
 
+template <typename TKey>
+void SelectDirectionAndRun()
+{
+    std::cout << "Select the kind of graph:\n"
+        << "1. Undirected\n"
+        << "2. Directed\n"
+        << "Enter choice (1 or 2): ";
+    int directionChoice;
+    std::cin >> directionChoice;
+
+    if (directionChoice == 2) {
+        Graph<TKey, double, Directed> graph;
+        GraphMenu(graph);
+    }
+    else {
+        Graph<TKey, double> graph;
+        GraphMenu(graph);
+    }
+}
+
 void interface()
 {
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
@@ -12,16 +32,13 @@ void interface()
     std::cin >> vertexTypeChoice;
 
     if (vertexTypeChoice == 1) {
-        Graph<int, double> graph;
-        GraphMenu(graph);
+        SelectDirectionAndRun<int>();
     }
     else if (vertexTypeChoice == 2) {
-        Graph<std::string, double> graph;
-        GraphMenu(graph);
+        SelectDirectionAndRun<std::string>();
     }
     else {
         std::cout << "Invalid choice. Exiting.\n";
         interface();
     }
 }
-
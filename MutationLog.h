@@ -0,0 +1,259 @@
+#pragma once
+#include "Graph.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Write-ahead log of graph mutations. Mutations made through the log are applied to the graph
+// and appended as binary records to an in-memory group; Commit (or a full group) writes the
+// group to <base>.log in one write, so persisting a mutation costs O(1).
+// Checkpoint folds the log into a SaveToFile snapshot <base>.snapshot and empties the log;
+// Recover loads the snapshot and replays the log on top of it.
+//
+// Record: uint32 payload size, uint32 FNV-1a checksum of the payload, payload = op byte, keys
+// (raw bytes, strings as uint32 length + bytes), weight (raw bytes). A torn record at the end of
+// the log (a crash in the middle of a write) fails its checksum and is cut off by Recover.
+// Replaying records that are already part of the snapshot does not change the graph, so a crash
+// between writing the snapshot and emptying the log loses nothing.
+template <typename TKey, typename WeightType = double, typename Direction = Undirected>
+class MutationLog {
+private:
+    enum Operation : uint8_t {
+        OpInsertVertex = 1,
+        OpEraseVertex = 2,
+        OpConnectNodes = 3,
+        OpDisconnectNodes = 4,
+        OpSetEdgeWeight = 5
+    };
+
+    static constexpr int HeaderSize = 2 * sizeof(uint32_t);
+
+    Graph<TKey, WeightType, Direction>& graph;
+    std::string snapshotPath;
+    std::string logPath;
+    int groupSize;
+    // records of the current group, not yet written to the log
+    std::string pending;
+    int pendingRecords;
+    std::string payload;
+    std::ofstream out;
+
+    static uint32_t Checksum(const char* data, int size) {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; i < size; i++) {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    void PutBytes(const void* data, int size) {
+        payload.append(static_cast<const char*>(data), size);
+    }
+
+    void PutKey(const TKey& key) {
+        if constexpr (std::is_same<TKey, std::string>::value) {
+            uint32_t length = static_cast<uint32_t>(key.size());
+            PutBytes(&length, sizeof(length));
+            PutBytes(key.data(), static_cast<int>(length));
+        }
+        else {
+            static_assert(std::is_trivially_copyable<TKey>::value, "MutationLog needs trivially copyable or string keys");
+            PutBytes(&key, sizeof(TKey));
+        }
+    }
+
+    static bool GetBytes(const char* data, int size, int& position, void* target, int count) {
+        if (position + count > size)
+            return false;
+        std::memcpy(target, data + position, count);
+        position += count;
+        return true;
+    }
+
+    static bool GetKey(const char* data, int size, int& position, TKey& key) {
+        if constexpr (std::is_same<TKey, std::string>::value) {
+            uint32_t length = 0;
+            if (!GetBytes(data, size, position, &length, sizeof(length)) || position + static_cast<int>(length) > size)
+                return false;
+            key.assign(data + position, length);
+            position += static_cast<int>(length);
+            return true;
+        }
+        else {
+            return GetBytes(data, size, position, &key, sizeof(TKey));
+        }
+    }
+
+    void Record(Operation op, const TKey& from, const TKey* to, const WeightType* weight) {
+        payload.clear();
+        uint8_t code = op;
+        PutBytes(&code, 1);
+        PutKey(from);
+        if (to) PutKey(*to);
+        if (weight) PutBytes(weight, sizeof(WeightType));
+
+        int size = static_cast<int>(payload.size());
+        uint32_t header[2] = { static_cast<uint32_t>(size), Checksum(payload.data(), size) };
+        pending.append(reinterpret_cast<const char*>(header), HeaderSize);
+        pending.append(payload);
+        if (++pendingRecords >= groupSize) {
+            Commit();
+        }
+    }
+
+    // Applies one record payload; false if it is malformed
+    bool Apply(const char* data, int size) {
+        int position = 0;
+        uint8_t op = 0;
+        TKey from, to;
+        WeightType weight;
+        if (!GetBytes(data, size, position, &op, 1) || !GetKey(data, size, position, from))
+            return false;
+        switch (op) {
+        case OpInsertVertex:
+            graph.InsertVertex(from);
+            return true;
+        case OpEraseVertex:
+            graph.EraseVertex(from);
+            return true;
+        case OpDisconnectNodes:
+            if (!GetKey(data, size, position, to)) return false;
+            graph.DisconnectNodes(from, to);
+            return true;
+        case OpConnectNodes:
+        case OpSetEdgeWeight:
+            if (!GetKey(data, size, position, to) || !GetBytes(data, size, position, &weight, sizeof(WeightType)))
+                return false;
+            if (op == OpConnectNodes) graph.ConnectNodes(from, to, weight);
+            else if (graph.HasEdge(from, to)) graph.SetEdgeWeight(from, to, weight);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void OpenLog(bool truncate) {
+        out.close();
+        out.clear();
+        out.open(logPath, std::ios::binary | (truncate ? std::ios::trunc : std::ios::app));
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open the mutation log.");
+        }
+    }
+
+public:
+    // groupSize records are collected before they are written together
+    MutationLog(Graph<TKey, WeightType, Direction>& graph, const std::string& basePath, int groupSize = 64)
+        : graph(graph), snapshotPath(basePath + ".snapshot"), logPath(basePath + ".log"),
+          groupSize(groupSize > 0 ? groupSize : 1), pending(), pendingRecords(0), payload() {}
+
+    MutationLog(const MutationLog&) = delete;
+    MutationLog& operator=(const MutationLog&) = delete;
+
+    ~MutationLog() {
+        try {
+            Commit();
+        }
+        catch (...) {
+        }
+    }
+
+    // Rebuilds the graph from the snapshot and the log; returns the number of replayed records
+    int Recover() {
+        pending.clear();
+        pendingRecords = 0;
+        out.close();
+        graph.ClearGraph();
+        if (std::filesystem::exists(snapshotPath)) {
+            graph.LoadFromFile(snapshotPath.c_str());
+        }
+
+        int replayed = 0;
+        long long goodBytes = 0;
+        std::ifstream in(logPath, std::ios::binary);
+        if (in.is_open()) {
+            long long fileSize = static_cast<long long>(std::filesystem::file_size(logPath));
+            std::string record;
+            uint32_t header[2];
+            while (in.read(reinterpret_cast<char*>(header), HeaderSize)) {
+                int size = static_cast<int>(header[0]);
+                if (size <= 0 || goodBytes + HeaderSize + size > fileSize) break;
+                record.resize(size);
+                if (!in.read(&record[0], size) || Checksum(&record[0], size) != header[1] || !Apply(&record[0], size))
+                    break;
+                goodBytes += HeaderSize + size;
+                replayed++;
+            }
+            in.close();
+            // drop a torn or corrupt tail so that new records follow the last good one
+            if (fileSize != goodBytes) {
+                std::filesystem::resize_file(logPath, static_cast<std::uintmax_t>(goodBytes));
+            }
+        }
+        OpenLog(false);
+        return replayed;
+    }
+
+    void InsertVertex(const TKey& vertex) {
+        unsigned long long before = graph.GetVersion();
+        graph.InsertVertex(vertex);
+        if (graph.GetVersion() != before) Record(OpInsertVertex, vertex, nullptr, nullptr);
+    }
+
+    void EraseVertex(const TKey& vertex) {
+        unsigned long long before = graph.GetVersion();
+        graph.EraseVertex(vertex);
+        if (graph.GetVersion() != before) Record(OpEraseVertex, vertex, nullptr, nullptr);
+    }
+
+    void ConnectNodes(const TKey& from, const TKey& to, WeightType weight) {
+        unsigned long long before = graph.GetVersion();
+        graph.ConnectNodes(from, to, weight);
+        if (graph.GetVersion() != before) Record(OpConnectNodes, from, &to, &weight);
+    }
+
+    void DisconnectNodes(const TKey& from, const TKey& to) {
+        unsigned long long before = graph.GetVersion();
+        graph.DisconnectNodes(from, to);
+        if (graph.GetVersion() != before) Record(OpDisconnectNodes, from, &to, nullptr);
+    }
+
+    void SetEdgeWeight(const TKey& from, const TKey& to, WeightType weight) {
+        graph.SetEdgeWeight(from, to, weight);
+        Record(OpSetEdgeWeight, from, &to, &weight);
+    }
+
+    // Writes the current group to the log with a single write
+    void Commit() {
+        if (pendingRecords == 0)
+            return;
+        if (!out.is_open()) {
+            OpenLog(false);
+        }
+        out.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed to write the mutation log.");
+        }
+        pending.clear();
+        pendingRecords = 0;
+    }
+
+    // Number of mutations that are applied to the graph but not written yet
+    int GetPendingCount() const {
+        return pendingRecords;
+    }
+
+    // Replaces the snapshot with the current graph and empties the log
+    void Checkpoint() {
+        Commit();
+        std::string temporary = snapshotPath + ".tmp";
+        graph.SaveToFile(temporary.c_str());
+        std::filesystem::rename(temporary, snapshotPath);
+        OpenLog(true);
+    }
+};
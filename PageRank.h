@@ -0,0 +1,149 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Graph.h"
+#include "SparseMatrix.h"
+#include <cmath>
+#include <stdexcept>
+
+// How an iteration moves rank along the edges: Pull gathers over the in-edges of every vertex
+// (no write conflicts), Push scatters over the out-edges (per-thread buffers, then a sum).
+// Both compute the same ranks up to rounding.
+enum class PropagationMode {
+    Pull,
+    Push
+};
+
+// rank sums to 1. residual is the L1 change of the last iteration; converged means it fell below
+// the tolerance within the iteration limit.
+struct PageRankResult {
+    DynamicArray<double> rank;
+    int iterations = 0;
+    double residual = 0.0;
+    bool converged = false;
+};
+
+namespace PageRankDetail {
+
+    // Sum of the out-edge weights of every vertex; rank of a vertex with sum 0 is dangling
+    template <typename TKey, typename WeightPolicy>
+    DynamicArray<double> OutWeights(const CsrGraph<TKey, WeightPolicy>& graph)
+    {
+        int numNodes = graph.GetNodeCount();
+        DynamicArray<double> out(numNodes);
+        for (int u = 0; u < numNodes; u++) {
+            double sum = 0.0;
+            graph.ForEachNeighbor(u, [&](int, typename WeightPolicy::ValueType w) {
+                if (w < 0)
+                    throw std::invalid_argument("PageRank: edge weights must not be negative");
+                sum += static_cast<double>(w);
+            });
+            out.Append(sum);
+        }
+        return out;
+    }
+
+    // Power iteration of rank = damping * (M rank + dangling mass * teleport) + (1 - damping) * teleport,
+    // where M(v, u) = weight(u, v) / outWeight(u) and teleport sums to 1
+    template <typename TKey, typename WeightPolicy>
+    PageRankResult Iterate(const CsrGraph<TKey, WeightPolicy>& graph, const DynamicArray<double>& teleport,
+        double damping, double tolerance, int maxIterations, PropagationMode mode)
+    {
+        if (!(damping >= 0.0 && damping < 1.0))
+            throw std::invalid_argument("PageRank: damping must be in [0, 1)");
+        int numNodes = graph.GetNodeCount();
+        DynamicArray<double> outWeight = OutWeights(graph);
+        auto coefficient = [&outWeight](int u, int, double w) {
+            return outWeight[u] > 0.0 ? w / outWeight[u] : 0.0;
+        };
+        SparseMatrix matrix = mode == PropagationMode::Pull ? PullMatrix(graph, coefficient) : PushMatrix(graph, coefficient);
+
+        PageRankResult result;
+        result.rank = DynamicArray<double>(numNodes);
+        DynamicArray<double> next(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            result.rank.Append(teleport[v]);
+            next.Append(0.0);
+        }
+        const double* jump = teleport.data();
+        const double* out = outWeight.data();
+        while (result.iterations < maxIterations && numNodes > 0) {
+            double* rank = result.rank.data();
+            double dangling = 0.0;
+            for (int u = 0; u < numNodes; u++) {
+                if (out[u] == 0.0) dangling += rank[u];
+            }
+            if (mode == PropagationMode::Pull) {
+                Multiply(matrix, result.rank, next);
+            }
+            else {
+                double* clear = next.data();
+                for (int v = 0; v < numNodes; v++) {
+                    clear[v] = 0.0;
+                }
+                MultiplyScatter(matrix, result.rank, next);
+            }
+
+            const double* propagated = next.data();
+            double base = damping * dangling + (1.0 - damping);
+            double residual = 0.0;
+            for (int v = 0; v < numNodes; v++) {
+                double value = damping * propagated[v] + base * jump[v];
+                residual += std::fabs(value - rank[v]);
+                rank[v] = value;
+            }
+            result.iterations++;
+            result.residual = residual;
+            if (residual < tolerance) {
+                result.converged = true;
+                break;
+            }
+        }
+        return result;
+    }
+
+}
+
+// PageRank with teleportation to a uniformly chosen vertex; an edge is followed with probability
+// proportional to its weight, and the rank of vertices without out-weight is spread like a teleport
+template <typename TKey, typename WeightPolicy>
+PageRankResult PageRank(const CsrGraph<TKey, WeightPolicy>& graph, double damping = 0.85, double tolerance = 1e-10,
+    int maxIterations = 100, PropagationMode mode = PropagationMode::Pull)
+{
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<double> teleport(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        teleport.Append(1.0 / numNodes);
+    }
+    return PageRankDetail::Iterate(graph, teleport, damping, tolerance, maxIterations, mode);
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+PageRankResult PageRank(const Graph<TKey, WeightType, Direction>& graph, double damping = 0.85,
+    double tolerance = 1e-10, int maxIterations = 100, PropagationMode mode = PropagationMode::Pull)
+{
+    return PageRank(CsrGraph<TKey, ExactWeights<WeightType>>(graph), damping, tolerance, maxIterations, mode);
+}
+
+// PageRank that teleports to vertex v with probability proportional to preference[v] (indexed by
+// vertex id, non-negative, not all zero), e.g. 1 for a set of seed vertices and 0 elsewhere
+template <typename TKey, typename WeightPolicy>
+PageRankResult PersonalizedPageRank(const CsrGraph<TKey, WeightPolicy>& graph, const DynamicArray<double>& preference,
+    double damping = 0.85, double tolerance = 1e-10, int maxIterations = 100, PropagationMode mode = PropagationMode::Pull)
+{
+    int numNodes = graph.GetNodeCount();
+    if (preference.GetLength() != numNodes)
+        throw std::invalid_argument("PersonalizedPageRank: preference size differs from the node count");
+    double sum = 0.0;
+    for (int v = 0; v < numNodes; v++) {
+        if (preference[v] < 0.0)
+            throw std::invalid_argument("PersonalizedPageRank: negative preference");
+        sum += preference[v];
+    }
+    if (numNodes > 0 && !(sum > 0.0))
+        throw std::invalid_argument("PersonalizedPageRank: preferences are all zero");
+    DynamicArray<double> teleport(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        teleport.Append(preference[v] / sum);
+    }
+    return PageRankDetail::Iterate(graph, teleport, damping, tolerance, maxIterations, mode);
+}
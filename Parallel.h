@@ -0,0 +1,319 @@
+#pragma once
+#include "DynamicArray.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+// Number of threads used by the parallel algorithms, 0 means std::thread::hardware_concurrency()
+inline int& ThreadCountSetting() {
+    static int count = 0;
+    return count;
+}
+
+inline void SetThreadCount(int count) {
+    ThreadCountSetting() = count < 0 ? 0 : count;
+}
+
+inline int GetThreadCount() {
+    int count = ThreadCountSetting();
+    if (count == 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return count > 0 ? count : 1;
+}
+
+// Ranges shorter than this are not worth handing to another thread
+constexpr int ParallelGrainSize = 512;
+
+// Work-stealing pool behind ParallelForBlocks. The calling thread is worker 0 and the other workers
+// are threads started on first use; they sleep between loops and are restarted only when a loop asks
+// for another number of workers. A loop starts as one range in the deque of worker 0. A worker splits the
+// range it takes in halves, keeps the lower half and pushes the upper one to the back of its deque,
+// down to the grain size; it takes its own ranges from the back, and when its deque is empty it
+// steals the oldest (largest) range from the front of another deque.
+// One loop runs at a time: a loop started inside a loop body or from another thread while a loop
+// runs is executed serially by its caller.
+class ThreadPool {
+private:
+    struct Range {
+        int begin;
+        int end;
+    };
+
+    // Deque of one worker; ranges before head have been stolen
+    struct alignas(64) Worker {
+        std::mutex lock;
+        DynamicArray<Range> ranges;
+        int head = 0;
+    };
+
+    using Invoke = void (*)(void* body, int blockBegin, int blockEnd, int worker);
+
+    Worker* workers;
+    std::thread** threads;
+    int workerCount;
+
+    std::mutex jobLock;
+    std::mutex stateLock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    long long generation;
+    int busy;
+    bool stopping;
+
+    // the running loop
+    Invoke invoke;
+    void* loopBody;
+    int grain;
+    std::atomic<long long> remaining;
+    std::exception_ptr failure;
+
+    static bool& InsideLoop() {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    void Push(int worker, Range range) {
+        std::lock_guard<std::mutex> guard(workers[worker].lock);
+        workers[worker].ranges.Append(range);
+    }
+
+    bool PopBack(int worker, Range& range) {
+        Worker& own = workers[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (own.ranges.GetLength() == own.head)
+            return false;
+        range = own.ranges[own.ranges.GetLength() - 1];
+        own.ranges.Truncate(own.ranges.GetLength() - 1);
+        if (own.ranges.GetLength() == own.head) {
+            own.ranges.Truncate(0);
+            own.head = 0;
+        }
+        return true;
+    }
+
+    bool Steal(int thief, Range& range) {
+        for (int i = 1; i < workerCount; i++) {
+            Worker& victim = workers[(thief + i) % workerCount];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.ranges.GetLength() == victim.head)
+                continue;
+            range = victim.ranges[victim.head++];
+            if (victim.ranges.GetLength() == victim.head) {
+                victim.ranges.Truncate(0);
+                victim.head = 0;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void Execute(Range range, int worker) {
+        while (range.end - range.begin > grain) {
+            int middle = range.begin + (range.end - range.begin) / 2;
+            Push(worker, Range{ middle, range.end });
+            range.end = middle;
+        }
+        try {
+            invoke(loopBody, range.begin, range.end, worker);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(stateLock);
+            if (!failure) failure = std::current_exception();
+        }
+        remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+    }
+
+    // Takes part in the running loop until all of its elements are done
+    void Participate(int worker) {
+        InsideLoop() = true;
+        Range range;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (PopBack(worker, range) || Steal(worker, range)) {
+                Execute(range, worker);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        InsideLoop() = false;
+    }
+
+    // seen is the generation at the start of the thread, so that earlier loops are not rejoined
+    void Run(int worker, long long seen) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(stateLock);
+                wake.wait(guard, [&]() { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+            Participate(worker);
+            {
+                std::lock_guard<std::mutex> guard(stateLock);
+                busy--;
+            }
+            idle.notify_all();
+        }
+    }
+
+    void Start(int count) {
+        workerCount = count;
+        workers = new Worker[count];
+        threads = new std::thread*[count];
+        stopping = false;
+        for (int w = 1; w < count; w++) {
+            threads[w] = new std::thread(&ThreadPool::Run, this, w, generation);
+        }
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (int w = 1; w < workerCount; w++) {
+            threads[w]->join();
+            delete threads[w];
+        }
+        delete[] threads;
+        delete[] workers;
+    }
+
+public:
+    explicit ThreadPool(int count)
+        : workers(nullptr), threads(nullptr), workerCount(0), generation(0), busy(0), stopping(false),
+          invoke(nullptr), loopBody(nullptr), grain(1), remaining(0) {
+        Start(count < 1 ? 1 : count);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        Stop();
+    }
+
+    int GetWorkerCount() const {
+        return workerCount;
+    }
+
+    // Calls body(blockBegin, blockEnd, worker) for blocks of at most grainSize elements covering
+    // [begin, end) on count workers, so worker is always in [0, count), and returns when all are done.
+    // A worker runs one block at a time. The first exception thrown by a block is rethrown here once
+    // the other blocks are finished.
+    template <typename Body>
+    void ForBlocks(int begin, int end, int grainSize, int count, Body& body) {
+        if (end <= begin)
+            return;
+        // checked first: the thread running a loop already holds jobLock
+        if (InsideLoop()) {
+            body(begin, end, 0);
+            return;
+        }
+        std::unique_lock<std::mutex> job(jobLock, std::try_to_lock);
+        if (!job.owns_lock()) {
+            body(begin, end, 0);
+            return;
+        }
+        if (count < 1) count = 1;
+        if (count != workerCount) {
+            // no loop runs while jobLock is held, so the threads can be replaced
+            Stop();
+            Start(count);
+        }
+        if (workerCount == 1) {
+            body(begin, end, 0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            invoke = [](void* erased, int blockBegin, int blockEnd, int worker) {
+                (*static_cast<Body*>(erased))(blockBegin, blockEnd, worker);
+            };
+            loopBody = &body;
+            grain = grainSize < 1 ? 1 : grainSize;
+            failure = nullptr;
+            remaining.store(end - begin, std::memory_order_release);
+            Push(0, Range{ begin, end });
+            busy = workerCount - 1;
+            generation++;
+        }
+        wake.notify_all();
+        Participate(0);
+        std::exception_ptr error;
+        {
+            // the loop state may be reused only after every worker has left it
+            std::unique_lock<std::mutex> guard(stateLock);
+            idle.wait(guard, [&]() { return busy == 0; });
+            error = failure;
+            failure = nullptr;
+        }
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// The pool shared by all parallel algorithms; every loop runs on GetThreadCount() workers
+inline ThreadPool& GetThreadPool() {
+    static ThreadPool pool(GetThreadCount());
+    return pool;
+}
+
+// Calls body(blockBegin, blockEnd, worker) for blocks covering [begin, end) on the shared pool.
+// Ranges are halved while they are longer than the grain, so a block holds between about half the
+// grain and the grain. The grain is grainSize (pass a smaller one when every element is expensive),
+// raised to 1/8 of a thread's share on long ranges so that idle workers still find ranges to steal.
+// A worker can run several blocks, one after another; worker is in [0, GetThreadCount()), so it
+// can index per-thread buffers sized by GetThreadCount() before the call.
+template <typename Body>
+void ParallelForBlocks(int begin, int end, Body body, int grainSize = ParallelGrainSize) {
+    if (end <= begin)
+        return;
+    int threads = GetThreadCount();
+    if (grainSize < 1) grainSize = 1;
+    if (threads == 1 || end - begin <= grainSize) {
+        body(begin, end, 0);
+        return;
+    }
+    int adaptive = (end - begin) / (8 * threads);
+    GetThreadPool().ForBlocks(begin, end, adaptive > grainSize ? adaptive : grainSize, threads, body);
+}
+
+// Calls body(i) for every i in [begin, end)
+template <typename Body>
+void ParallelFor(int begin, int end, Body body, int grainSize = ParallelGrainSize) {
+    ParallelForBlocks(begin, end, [&body](int blockBegin, int blockEnd, int) {
+        for (int i = blockBegin; i < blockEnd; i++) {
+            body(i);
+        }
+    }, grainSize);
+}
+
+// combine(... combine(identity, map(i)) ...) over [begin, end): every worker folds its blocks into
+// its own partial result, and the partials are combined in worker order. combine must be
+// associative; the grouping depends on the scheduling, so floating-point sums may differ in the
+// last bits between runs.
+template <typename T, typename Map, typename Combine>
+T ParallelReduce(int begin, int end, const T& identity, Map map, Combine combine, int grainSize = ParallelGrainSize) {
+    int threads = GetThreadCount();
+    DynamicArray<T> partial(threads);
+    for (int t = 0; t < threads; t++) {
+        partial.Append(identity);
+    }
+    ParallelForBlocks(begin, end, [&](int blockBegin, int blockEnd, int worker) {
+        T value = partial[worker];
+        for (int i = blockBegin; i < blockEnd; i++) {
+            value = combine(value, map(i));
+        }
+        partial[worker] = value;
+    }, grainSize);
+    T result = identity;
+    for (int t = 0; t < threads; t++) {
+        result = combine(result, partial[t]);
+    }
+    return result;
+}
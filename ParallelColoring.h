@@ -0,0 +1,116 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Graph.h"
+#include "Hashing.h"
+#include "Parallel.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+// Jones-Plassmann coloring on the thread pool. A vertex is colored once all of its neighbors with a
+// higher priority are: every round colors, in parallel, the vertices whose counter of such neighbors
+// has dropped to zero (an independent set, so there are no conflicts) with their smallest free color,
+// then decrements the counters of their lower-priority neighbors, O(V + E) work in total.
+// Priorities are a hash of the vertex id, which keeps the number of rounds small and makes the
+// colors independent of the thread count. They are valid but usually differ from GraphColoring.
+
+namespace ColoringDetail {
+
+    // visit(neighbor) for the out-neighbors, and for directed graphs the in-neighbors, of v
+    template <typename TKey, typename WeightPolicy, typename Visit>
+    void ForEachAdjacent(const CsrGraph<TKey, WeightPolicy>& graph, int v, Visit visit)
+    {
+        for (int e = graph.RowBegin(v); e < graph.RowEnd(v); e++) {
+            visit(graph.GetTarget(e));
+        }
+        if (graph.IsDirected()) {
+            for (int e = graph.InRowBegin(v); e < graph.InRowEnd(v); e++) {
+                visit(graph.GetSource(e));
+            }
+        }
+    }
+
+}
+
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> ParallelGraphColoring(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    int numNodes = graph.GetNodeCount();
+    // MixHash is a bijection, so no two vertices share a priority
+    DynamicArray<uint64_t> priority(numNodes);
+    DynamicArray<int> colors(numNodes);
+    DynamicArray<int> first(numNodes);
+    DynamicArray<int> second(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        priority.Append(MixHash(static_cast<uint64_t>(v)));
+        colors.Append(-1);
+        first.Append(0);
+        second.Append(0);
+    }
+    // the vertices colored in this round, and the ones that become ready for the next
+    int* frontier = first.data();
+    int* next = second.data();
+
+    // waiting[v] counts the neighbors with a higher priority that are not colored yet
+    std::atomic<int>* waiting = new std::atomic<int>[numNodes > 0 ? numNodes : 1];
+    std::atomic<int> nextCount(0);
+    ParallelFor(0, numNodes, [&](int v) {
+        int count = 0;
+        uint64_t own = priority[v];
+        ColoringDetail::ForEachAdjacent(graph, v, [&](int u) {
+            count += priority[u] > own;
+        });
+        waiting[v].store(count, std::memory_order_relaxed);
+        if (count == 0) next[nextCount.fetch_add(1, std::memory_order_relaxed)] = v;
+    });
+
+    // forbidden[c + 1] == v means that color c is used by a neighbor of v, and forbidden[0] takes
+    // the uncolored neighbors without a branch; one table per worker
+    int threads = GetThreadCount();
+    DynamicArray<DynamicArray<int>> local(threads);
+    for (int t = 0; t < threads; t++) {
+        local.Append(DynamicArray<int>());
+    }
+
+    while (nextCount.load(std::memory_order_relaxed) > 0) {
+        int frontierSize = nextCount.load(std::memory_order_relaxed);
+        std::swap(frontier, next);
+        nextCount.store(0, std::memory_order_relaxed);
+        // the frontier is an independent set whose higher-priority neighbors are all colored, so the
+        // colors read here are final; a neighbor that becomes ready is colored in the next round
+        ParallelForBlocks(0, frontierSize, [&](int blockBegin, int blockEnd, int worker) {
+            DynamicArray<int>& forbidden = local[worker];
+            if (forbidden.GetLength() == 0) {
+                forbidden.Reserve(numNodes + 2);
+                for (int c = 0; c <= numNodes + 1; c++) {
+                    forbidden.Append(-1);
+                }
+            }
+            for (int i = blockBegin; i < blockEnd; i++) {
+                int v = frontier[i];
+                ColoringDetail::ForEachAdjacent(graph, v, [&](int u) {
+                    forbidden[colors[u] + 1] = v;
+                });
+                int c = 1;
+                while (forbidden[c] == v) {
+                    c++;
+                }
+                colors[v] = c - 1;
+                // the neighbors still uncolored are exactly the ones with a lower priority
+                ColoringDetail::ForEachAdjacent(graph, v, [&](int u) {
+                    if (colors[u] == -1 && waiting[u].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        next[nextCount.fetch_add(1, std::memory_order_relaxed)] = u;
+                    }
+                });
+            }
+        });
+    }
+    delete[] waiting;
+    return colors;
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<int> ParallelGraphColoring(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return ParallelGraphColoring(CsrGraph<TKey, ExactWeights<WeightType>>(graph));
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include "DefaultHash.h"
+#include "DynamicArray.h"
+#include "HashTable.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// Copy-on-write storage for Graph. Copies share reference-counted pieces; a piece is copied
+// the first time it is written through a copy that does not own it alone.
+// Shared pieces must not be written from several threads at once.
+
+// Array kept in reference-counted chunks of 1024 elements
+template <typename T>
+class SharedArray {
+private:
+    static constexpr int ChunkBits = 10;
+    static constexpr int ChunkSize = 1 << ChunkBits;
+    using Chunk = DynamicArray<T>;
+
+    DynamicArray<std::shared_ptr<Chunk>> chunks;
+    int length;
+
+    Chunk& Writable(int chunk) {
+        if (chunks[chunk].use_count() > 1) {
+            chunks[chunk] = std::make_shared<Chunk>(*chunks[chunk]);
+        }
+        return *chunks[chunk];
+    }
+
+public:
+    SharedArray() : chunks(), length(0) {}
+
+    int GetLength() const {
+        return length;
+    }
+
+    const T& operator[](int index) const {
+        if (index < 0 || index >= length)
+            throw std::out_of_range("Index out of range");
+        return (*chunks[index >> ChunkBits])[index & (ChunkSize - 1)];
+    }
+
+    void Set(int index, const T& value) {
+        if (index < 0 || index >= length)
+            throw std::out_of_range("Index out of range");
+        Writable(index >> ChunkBits)[index & (ChunkSize - 1)] = value;
+    }
+
+    void Append(const T& value) {
+        if (length == chunks.GetLength() * ChunkSize) {
+            chunks.Append(std::make_shared<Chunk>(ChunkSize));
+        }
+        Writable(length >> ChunkBits).Append(value);
+        length++;
+    }
+
+    void RemoveLast() {
+        if (length == 0)
+            throw std::out_of_range("RemoveLast: array is empty");
+        length--;
+        int last = chunks.GetLength() - 1;
+        if (length == last * ChunkSize) {
+            chunks[last].reset();
+            chunks.Truncate(last);
+        }
+        else {
+            Chunk& chunk = Writable(last);
+            chunk.Truncate(chunk.GetLength() - 1);
+        }
+    }
+
+    void Clear() {
+        chunks = DynamicArray<std::shared_ptr<Chunk>>();
+        length = 0;
+    }
+};
+
+// Hash table split into reference-counted segments (HashTable instances) selected by the high
+// bits of the hash. Values that are not trivially copyable are boxed in their own
+// reference-counted cells, so copying a segment copies pointers only and a write copies just
+// the touched value. The number of segments doubles as the table grows, which keeps
+// a segment near SegmentLoad entries and a copy of the table at O(size / SegmentLoad).
+template <typename Key, typename Value, typename HashFunc = DefaultHash<Key>>
+class SharedTable {
+private:
+    static constexpr bool Boxed = !std::is_trivially_copyable<Value>::value;
+    static constexpr int SegmentLoad = 512;
+    using Stored = typename std::conditional<Boxed, std::shared_ptr<Value>, Value>::type;
+    using Segment = HashTable<Key, Stored, HashFunc>;
+
+    DynamicArray<std::shared_ptr<Segment>> segments;
+    int segmentBits;
+    int count;
+    HashFunc hashFunc;
+
+    int SegmentOf(const Key& key) const {
+        if (segmentBits == 0)
+            return 0;
+        uint64_t hash = static_cast<uint64_t>(hashFunc(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<int>(hash >> (64 - segmentBits));
+    }
+
+    Segment& Writable(int segment) {
+        if (segments[segment].use_count() > 1) {
+            segments[segment] = std::make_shared<Segment>(*segments[segment]);
+        }
+        return *segments[segment];
+    }
+
+    static const Value* Unbox(const Stored* stored) {
+        if constexpr (Boxed) {
+            return stored ? stored->get() : nullptr;
+        }
+        else {
+            return stored;
+        }
+    }
+
+    // Doubles the number of segments; the old segments may still be shared, so they are only read
+    void Split() {
+        DynamicArray<std::shared_ptr<Segment>> old = segments;
+        segmentBits++;
+        int segmentCount = 1 << segmentBits;
+        segments = DynamicArray<std::shared_ptr<Segment>>(segmentCount);
+        for (int i = 0; i < segmentCount; i++) {
+            segments.Append(std::make_shared<Segment>(SegmentLoad + 11));
+        }
+        for (int s = 0; s < old.GetLength(); s++) {
+            for (int i = 0; i < old[s]->getCapacity(); i++) {
+                HashEntry<Key, Stored> entry = old[s]->getEntry(i);
+                if (entry.status == EntryStatus::OCCUPIED) {
+                    segments[SegmentOf(entry.pair.key)]->insert(entry.pair.key, entry.pair.value);
+                }
+            }
+        }
+    }
+
+public:
+    explicit SharedTable(int initialCapacity = 11) : segments(), segmentBits(0), count(0), hashFunc() {
+        segments.Append(std::make_shared<Segment>(initialCapacity));
+    }
+
+    // Read access never copies anything
+    const Value* find(const Key& key) const {
+        return Unbox(static_cast<const Segment&>(*segments[SegmentOf(key)]).find(key));
+    }
+
+    // Write access: the segment and the value become private to this table first
+    Value* find(const Key& key) {
+        int segment = SegmentOf(key);
+        // a shared segment is copied only if the key is really there
+        if (segments[segment].use_count() > 1 && !static_cast<const Segment&>(*segments[segment]).find(key))
+            return nullptr;
+        Stored* stored = Writable(segment).find(key);
+        if (!stored)
+            return nullptr;
+        if constexpr (Boxed) {
+            if (stored->use_count() > 1) {
+                *stored = std::make_shared<Value>(**stored);
+            }
+            return stored->get();
+        }
+        else {
+            return stored;
+        }
+    }
+
+    bool exist(const Key& key) const {
+        return segments[SegmentOf(key)]->exist(key);
+    }
+
+    Value get(const Key& key) const {
+        const Value* value = find(key);
+        if (!value)
+            throw std::runtime_error("Key not found in HashTable.");
+        return *value;
+    }
+
+    void insert(const Key& key, const Value& value) {
+        Segment& segment = Writable(SegmentOf(key));
+        int sizeBefore = segment.size();
+        if constexpr (Boxed) {
+            segment.insert(key, std::make_shared<Value>(value));
+        }
+        else {
+            segment.insert(key, value);
+        }
+        if (segment.size() != sizeBefore && ++count > (SegmentLoad << segmentBits)) {
+            Split();
+        }
+    }
+
+    bool remove(const Key& key) {
+        int segment = SegmentOf(key);
+        if (!segments[segment]->exist(key))
+            return false;
+        Writable(segment).remove(key);
+        count--;
+        return true;
+    }
+
+    void Clear() {
+        segments = DynamicArray<std::shared_ptr<Segment>>();
+        segments.Append(std::make_shared<Segment>(11));
+        segmentBits = 0;
+        count = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+};
@@ -0,0 +1,260 @@
+#pragma once
+#include "BinaryHeap.h"
+#include "Graph.h"
+#include "GraphUtils.h"
+#include "HashTable.h"
+#include "Pair.h"
+#include <limits>
+
+// Keeps MinDistances results for a set of hot sources.
+// Edge changes made through the cache repair every cached shortest-path tree in place:
+// insertions and weight decreases propagate the improvement from the changed edge,
+// deletions and weight increases recompute only the subtree hanging below the edge.
+// Any other mutation of the graph is detected through its version counter and makes
+// the entry recompute from scratch on the next query.
+template <typename TKey, typename WeightType = double, typename Direction = Undirected>
+class ShortestPathCache {
+private:
+    struct Entry {
+        int source = -1;
+        DynamicArray<int> dist;
+        DynamicArray<int> parent;
+        unsigned long long version = 0;
+    };
+
+    static constexpr int Unreachable = std::numeric_limits<int>::max();
+
+    Graph<TKey, WeightType, Direction>& graph;
+    HashTable<TKey, Entry> entries;
+    DynamicArray<TKey> sources;
+
+public:
+    explicit ShortestPathCache(Graph<TKey, WeightType, Direction>& graph)
+        : graph(graph), entries(11), sources() {}
+
+    // Same result as MinDistances(graph, source)
+    DynamicArray<PathInfo<TKey>> GetMinDistances(const TKey& source) {
+        const Entry& entry = Refresh(source);
+        int numNodes = graph.GetNodeCount();
+        DynamicArray<PathInfo<TKey>> result;
+        result.Reserve(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            PathInfo<TKey> pi;
+            if (entry.dist[i] != Unreachable) {
+                pi.distance = entry.dist[i];
+                pi.path = ReconstructPath<TKey>(i, entry.parent, graph);
+            }
+            else {
+                pi.distance = -1;
+            }
+            result.Append(pi);
+        }
+        return result;
+    }
+
+    // Distance from source to target, -1 if unreachable
+    int GetDistance(const TKey& source, const TKey& target) {
+        const Entry& entry = Refresh(source);
+        int index = graph.FindNodeIndex(target);
+        if (index == -1 || entry.dist[index] == Unreachable)
+            return -1;
+        return entry.dist[index];
+    }
+
+    bool IsCached(const TKey& source) const {
+        return entries.exist(source);
+    }
+
+    void Forget(const TKey& source) {
+        if (!entries.remove(source))
+            return;
+        for (int i = 0; i < sources.GetLength(); i++) {
+            if (sources[i] == source) {
+                sources.SwapRemoveAt(i);
+                break;
+            }
+        }
+    }
+
+    void Clear() {
+        entries.Clear();
+        sources.Clear();
+    }
+
+    void ConnectNodes(const TKey& from, const TKey& to, WeightType weight) {
+        unsigned long long before = graph.GetVersion();
+        graph.ConnectNodes(from, to, weight);
+        if (graph.GetVersion() == before)
+            return;
+        int u = graph.FindNodeIndex(from);
+        int v = graph.FindNodeIndex(to);
+        int w = static_cast<int>(weight);
+        ForEachSyncedEntry(before, [&](Entry& entry) {
+            RepairDecrease(entry, u, v, w);
+            if constexpr (!Direction::IsDirected) {
+                RepairDecrease(entry, v, u, w);
+            }
+        });
+    }
+
+    void DisconnectNodes(const TKey& from, const TKey& to) {
+        unsigned long long before = graph.GetVersion();
+        graph.DisconnectNodes(from, to);
+        if (graph.GetVersion() == before)
+            return;
+        int u = graph.FindNodeIndex(from);
+        int v = graph.FindNodeIndex(to);
+        ForEachSyncedEntry(before, [&](Entry& entry) {
+            RepairIncrease(entry, u, v);
+            if constexpr (!Direction::IsDirected) {
+                RepairIncrease(entry, v, u);
+            }
+        });
+    }
+
+    void SetEdgeWeight(const TKey& from, const TKey& to, WeightType weight) {
+        int oldWeight = static_cast<int>(graph.GetEdgeWeight(from, to));
+        int newWeight = static_cast<int>(weight);
+        unsigned long long before = graph.GetVersion();
+        graph.SetEdgeWeight(from, to, weight);
+        int u = graph.FindNodeIndex(from);
+        int v = graph.FindNodeIndex(to);
+        ForEachSyncedEntry(before, [&](Entry& entry) {
+            if (newWeight < oldWeight) {
+                RepairDecrease(entry, u, v, newWeight);
+                if constexpr (!Direction::IsDirected) {
+                    RepairDecrease(entry, v, u, newWeight);
+                }
+            }
+            else if (newWeight > oldWeight) {
+                RepairIncrease(entry, u, v);
+                if constexpr (!Direction::IsDirected) {
+                    RepairIncrease(entry, v, u);
+                }
+            }
+        });
+    }
+
+private:
+    const Entry& Refresh(const TKey& source) {
+        Entry* entry = entries.find(source);
+        if (!entry) {
+            entries.insert(source, Entry());
+            sources.Append(source);
+            entry = entries.find(source);
+        }
+        else if (entry->version == graph.GetVersion()) {
+            return *entry;
+        }
+        Compute(source, *entry);
+        return *entry;
+    }
+
+    template <typename Action>
+    void ForEachSyncedEntry(unsigned long long before, Action action) {
+        for (int i = 0; i < sources.GetLength(); i++) {
+            Entry* entry = entries.find(sources[i]);
+            if (entry->version != before)
+                continue;
+            action(*entry);
+            entry->version = graph.GetVersion();
+        }
+    }
+
+    void Compute(const TKey& source, Entry& entry) {
+        int numNodes = graph.GetNodeCount();
+        entry.dist = DynamicArray<int>(numNodes);
+        entry.parent = DynamicArray<int>(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            entry.dist.Append(Unreachable);
+            entry.parent.Append(-1);
+        }
+        entry.source = graph.FindNodeIndex(source);
+        entry.version = graph.GetVersion();
+        if (entry.source == -1)
+            return;
+
+        BinaryHeap<Pair<int, int>> heap;
+        entry.dist[entry.source] = 0;
+        heap.Push(Pair<int, int>(0, entry.source));
+        Propagate(entry, heap);
+    }
+
+    // Dijkstra from the vertices already in the heap; only improvements are pushed
+    void Propagate(Entry& entry, BinaryHeap<Pair<int, int>>& heap) {
+        while (!heap.IsEmpty()) {
+            Pair<int, int> top = heap.Pop();
+            int u = top.value;
+            if (top.key > entry.dist[u])
+                continue;
+            auto edges = graph.GetAdjacentVertices(graph.GetVertex(u));
+            for (int e = 0; e < edges.GetLength(); e++) {
+                int v = graph.FindNodeIndex(edges[e].GetNode());
+                int newDist = top.key + static_cast<int>(edges[e].GetWeight());
+                if (newDist < entry.dist[v]) {
+                    entry.dist[v] = newDist;
+                    entry.parent[v] = u;
+                    heap.Push(Pair<int, int>(newDist, v));
+                }
+            }
+        }
+    }
+
+    void RepairDecrease(Entry& entry, int u, int v, int weight) {
+        if (entry.dist[u] == Unreachable || entry.dist[u] + weight >= entry.dist[v])
+            return;
+        entry.dist[v] = entry.dist[u] + weight;
+        entry.parent[v] = u;
+        BinaryHeap<Pair<int, int>> heap;
+        heap.Push(Pair<int, int>(entry.dist[v], v));
+        Propagate(entry, heap);
+    }
+
+    // The tree edge u -> v got longer or disappeared: reset the subtree of v and
+    // rebuild it from its incoming edges that start outside the subtree.
+    void RepairIncrease(Entry& entry, int u, int v) {
+        if (entry.parent[v] != u)
+            return;
+
+        HashTable<int, bool> inSubtree(11);
+        DynamicArray<int> subtree;
+        subtree.Append(v);
+        inSubtree.insert(v, true);
+        for (int i = 0; i < subtree.GetLength(); i++) {
+            int x = subtree[i];
+            auto edges = graph.GetAdjacentVertices(graph.GetVertex(x));
+            for (int e = 0; e < edges.GetLength(); e++) {
+                int child = graph.FindNodeIndex(edges[e].GetNode());
+                if (entry.parent[child] == x && !inSubtree.exist(child)) {
+                    inSubtree.insert(child, true);
+                    subtree.Append(child);
+                }
+            }
+        }
+
+        for (int i = 0; i < subtree.GetLength(); i++) {
+            entry.dist[subtree[i]] = Unreachable;
+            entry.parent[subtree[i]] = -1;
+        }
+
+        BinaryHeap<Pair<int, int>> heap;
+        for (int i = 0; i < subtree.GetLength(); i++) {
+            int x = subtree[i];
+            auto incoming = graph.GetIncomingVertices(graph.GetVertex(x));
+            for (int e = 0; e < incoming.GetLength(); e++) {
+                int p = graph.FindNodeIndex(incoming[e].GetNode());
+                if (inSubtree.exist(p) || entry.dist[p] == Unreachable)
+                    continue;
+                int newDist = entry.dist[p] + static_cast<int>(incoming[e].GetWeight());
+                if (newDist < entry.dist[x]) {
+                    entry.dist[x] = newDist;
+                    entry.parent[x] = p;
+                }
+            }
+            if (entry.dist[x] != Unreachable) {
+                heap.Push(Pair<int, int>(entry.dist[x], x));
+            }
+        }
+        Propagate(entry, heap);
+    }
+};
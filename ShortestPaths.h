@@ -0,0 +1,169 @@
+#pragma once
+#include "Bitmap.h"
+#include "CsrGraph.h"
+#include "GraphUtils.h"
+#include "Parallel.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace DeltaSteppingDetail {
+
+    // distance in the high half, predecessor in the low half, so both change in one CAS
+    inline uint64_t Pack(uint32_t distance, int predecessor) {
+        return (static_cast<uint64_t>(distance) << 32) | static_cast<uint32_t>(predecessor);
+    }
+
+    inline uint32_t DistanceOf(uint64_t packed) {
+        return static_cast<uint32_t>(packed >> 32);
+    }
+
+    constexpr uint32_t Infinity = std::numeric_limits<uint32_t>::max();
+
+    // Only a strictly shorter distance replaces the stored one; this keeps predecessor chains acyclic
+    inline bool RelaxMin(std::atomic<uint64_t>& slot, uint32_t distance, int predecessor) {
+        uint64_t current = slot.load(std::memory_order_relaxed);
+        while (distance < DistanceOf(current)) {
+            if (slot.compare_exchange_weak(current, Pack(distance, predecessor), std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+}
+
+// Delta-stepping SSSP (Meyer and Sanders). Vertices are kept in buckets of width delta;
+// the current bucket is settled by repeated parallel relaxation of its light edges (weight <= delta),
+// then the heavy edges of everything settled in it are relaxed once.
+// Distance updates are atomic min operations. delta <= 0 picks the average edge weight.
+template <typename TKey, typename WeightPolicy>
+SsspResult DeltaSteppingDistances(const CsrGraph<TKey, WeightPolicy>& graph, int source, int delta = 0)
+{
+    using namespace DeltaSteppingDetail;
+    int numNodes = graph.GetNodeCount();
+    int numEdges = graph.GetEdgeCount();
+
+    // rows reordered so that the light edges of every vertex come first
+    DynamicArray<int> targets(numEdges + 1);
+    DynamicArray<int> weights(numEdges + 1);
+    DynamicArray<int> lightEnd(numNodes + 1);
+    for (int e = 0; e < numEdges; e++) {
+        // a negative weight would wrap around in the unsigned distances below
+        if (graph.GetWeight(e) < 0)
+            throw std::invalid_argument("DeltaSteppingDistances: negative edge weight");
+        targets.Append(0);
+        weights.Append(static_cast<int>(graph.GetWeight(e)));
+    }
+    if (delta <= 0) {
+        long long sum = 0;
+        for (int e = 0; e < numEdges; e++) sum += weights[e];
+        delta = numEdges > 0 ? static_cast<int>(sum / numEdges) : 1;
+        if (delta < 1) delta = 1;
+    }
+    for (int u = 0; u < numNodes; u++) {
+        lightEnd.Append(0);
+    }
+    ParallelFor(0, numNodes, [&](int u) {
+        int front = graph.RowBegin(u);
+        int back = graph.RowEnd(u) - 1;
+        for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+            int w = static_cast<int>(graph.GetWeight(e));
+            int slot = w <= delta ? front++ : back--;
+            targets[slot] = graph.GetTarget(e);
+            weights[slot] = w;
+        }
+        lightEnd[u] = front;
+    });
+
+    std::atomic<uint64_t>* state = new std::atomic<uint64_t>[numNodes > 0 ? numNodes : 1];
+    for (int v = 0; v < numNodes; v++) {
+        state[v].store(Pack(Infinity, -1), std::memory_order_relaxed);
+    }
+
+    DynamicArray<DynamicArray<int>> buckets;
+    auto pushToBucket = [&](int v) {
+        int b = static_cast<int>(DistanceOf(state[v].load(std::memory_order_relaxed)) / static_cast<uint32_t>(delta));
+        while (buckets.GetLength() <= b) {
+            buckets.Append(DynamicArray<int>());
+        }
+        buckets[b].Append(v);
+    };
+
+    int threads = GetThreadCount();
+    DynamicArray<DynamicArray<int>> improved(threads);
+    for (int t = 0; t < threads; t++) {
+        improved.Append(DynamicArray<int>());
+    }
+    // relaxes edges [begin(u), end(u)) of every vertex in the list, collecting improved targets per worker
+    auto relax = [&](const DynamicArray<int>& vertices, bool light) {
+        ParallelForBlocks(0, vertices.GetLength(), [&](int blockBegin, int blockEnd, int worker) {
+            for (int i = blockBegin; i < blockEnd; i++) {
+                int u = vertices[i];
+                uint32_t du = DistanceOf(state[u].load(std::memory_order_relaxed));
+                int begin = light ? graph.RowBegin(u) : lightEnd[u];
+                int end = light ? lightEnd[u] : graph.RowEnd(u);
+                for (int e = begin; e < end; e++) {
+                    int v = targets[e];
+                    if (RelaxMin(state[v], du + static_cast<uint32_t>(weights[e]), u)) {
+                        improved[worker].Append(v);
+                    }
+                }
+            }
+        });
+        for (int t = 0; t < threads; t++) {
+            for (int i = 0; i < improved[t].GetLength(); i++) {
+                pushToBucket(improved[t][i]);
+            }
+            improved[t].Truncate(0);
+        }
+    };
+
+    if (source >= 0 && source < numNodes) {
+        state[source].store(Pack(0, -1), std::memory_order_relaxed);
+        pushToBucket(source);
+    }
+
+    Bitmap settled(numNodes);
+    for (int b = 0; b < buckets.GetLength(); b++) {
+        DynamicArray<int> settledHere;
+        while (buckets[b].GetLength() > 0) {
+            DynamicArray<int> frontier;
+            for (int i = 0; i < buckets[b].GetLength(); i++) {
+                int v = buckets[b][i];
+                // stale entries: the vertex has moved to a smaller bucket since it was pushed
+                if (DistanceOf(state[v].load(std::memory_order_relaxed)) / static_cast<uint32_t>(delta) != static_cast<uint32_t>(b))
+                    continue;
+                frontier.Append(v);
+                if (!settled.TestAndSet(v)) {
+                    settledHere.Append(v);
+                }
+            }
+            buckets[b].Truncate(0);
+            relax(frontier, true);
+        }
+        relax(settledHere, false);
+    }
+
+    SsspResult result;
+    result.distance = DynamicArray<int>(numNodes);
+    result.predecessor = DynamicArray<int>(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        uint64_t packed = state[v].load(std::memory_order_relaxed);
+        bool reached = DistanceOf(packed) != Infinity;
+        result.distance.Append(reached ? static_cast<int>(DistanceOf(packed)) : -1);
+        result.predecessor.Append(reached ? static_cast<int>(static_cast<uint32_t>(packed)) : -1);
+    }
+    delete[] state;
+    return result;
+}
+
+// Same output as MinDistances(graph, startNode), computed with delta-stepping
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<PathInfo<TKey>> DeltaSteppingMinDistances(const Graph<TKey, WeightType, Direction>& graph,
+    const TKey& startNode, int delta = 0)
+{
+    CsrGraph<TKey, ExactWeights<WeightType>> csr(graph);
+    SsspResult sssp = DeltaSteppingDistances(csr, csr.FindNodeIndex(startNode), delta);
+    return ToPathInfos<TKey>(graph, sssp);
+}
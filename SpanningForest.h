@@ -0,0 +1,173 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Parallel.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <atomic>
+
+template <typename TKey, typename WeightType>
+struct ForestEdge {
+    TKey from;
+    TKey to;
+    WeightType weight;
+};
+
+// Minimum spanning forest: one spanning tree per connected component
+template <typename TKey, typename WeightType>
+struct SpanningForest {
+    WeightType totalWeight = WeightType();
+    DynamicArray<ForestEdge<TKey, WeightType>> edges;
+};
+
+namespace ForestDetail {
+
+    template <typename ValueType>
+    struct IdEdge {
+        int from;
+        int to;
+        ValueType weight;
+    };
+
+    // Every undirected edge once (from < to); arcs of directed graphs are taken as undirected edges
+    template <typename TKey, typename WeightPolicy>
+    DynamicArray<IdEdge<typename WeightPolicy::ValueType>> CollectEdges(const CsrGraph<TKey, WeightPolicy>& graph)
+    {
+        DynamicArray<IdEdge<typename WeightPolicy::ValueType>> edges(graph.GetEdgeCount() + 1);
+        for (int u = 0; u < graph.GetNodeCount(); u++) {
+            for (int e = graph.RowBegin(u); e < graph.RowEnd(u); e++) {
+                int v = graph.GetTarget(e);
+                if (u == v || (!graph.IsDirected() && v < u))
+                    continue;
+                edges.Append({ u, v, graph.GetWeight(e) });
+            }
+        }
+        return edges;
+    }
+
+    template <typename TKey, typename WeightPolicy, typename ValueType>
+    void AddToForest(const CsrGraph<TKey, WeightPolicy>& graph, const IdEdge<ValueType>& edge,
+        SpanningForest<TKey, ValueType>& forest)
+    {
+        forest.totalWeight += edge.weight;
+        forest.edges.Append({ graph.GetVertex(edge.from), graph.GetVertex(edge.to), edge.weight });
+    }
+
+}
+
+// Kruskal: edges sorted by weight are added unless they close a cycle. O(E log E)
+template <typename TKey, typename WeightPolicy>
+SpanningForest<TKey, typename WeightPolicy::ValueType> KruskalSpanningForest(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    using ValueType = typename WeightPolicy::ValueType;
+    auto edges = ForestDetail::CollectEdges(graph);
+    if (edges.GetLength() > 0) {
+        std::sort(edges.begin(), edges.end(),
+            [](const ForestDetail::IdEdge<ValueType>& a, const ForestDetail::IdEdge<ValueType>& b) {
+                return a.weight < b.weight;
+            });
+    }
+
+    SpanningForest<TKey, ValueType> forest;
+    UnionFind sets(graph.GetNodeCount());
+    for (int i = 0; i < edges.GetLength() && forest.edges.GetLength() < graph.GetNodeCount() - 1; i++) {
+        if (sets.Union(edges[i].from, edges[i].to)) {
+            ForestDetail::AddToForest(graph, edges[i], forest);
+        }
+    }
+    return forest;
+}
+
+// Boruvka: in every round each component picks its lightest outgoing edge in parallel and
+// all picked edges are merged at once, so there are at most log V rounds of O(E) work.
+// Ties are broken by edge position, which keeps the picked edges cycle-free.
+template <typename TKey, typename WeightPolicy>
+SpanningForest<TKey, typename WeightPolicy::ValueType> BoruvkaSpanningForest(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    using ValueType = typename WeightPolicy::ValueType;
+    int numNodes = graph.GetNodeCount();
+    auto edges = ForestDetail::CollectEdges(graph);
+    ConcurrentUnionFind sets(numNodes);
+    std::atomic<int>* lightest = new std::atomic<int>[numNodes > 0 ? numNodes : 1];
+
+    auto lighter = [&edges](int a, int b) {
+        return edges[a].weight < edges[b].weight || (edges[a].weight == edges[b].weight && a < b);
+    };
+    auto offer = [&](int root, int edge) {
+        int current = lightest[root].load(std::memory_order_relaxed);
+        while ((current == -1 || lighter(edge, current)) &&
+            !lightest[root].compare_exchange_weak(current, edge, std::memory_order_relaxed)) {
+        }
+    };
+
+    // positions of the edges that still connect two different components
+    DynamicArray<int> alive(edges.GetLength() + 1);
+    for (int i = 0; i < edges.GetLength(); i++) {
+        alive.Append(i);
+    }
+
+    SpanningForest<TKey, ValueType> forest;
+    int threads = GetThreadCount();
+    while (alive.GetLength() > 0) {
+        ParallelFor(0, numNodes, [&](int v) { lightest[v].store(-1, std::memory_order_relaxed); });
+        ParallelFor(0, alive.GetLength(), [&](int i) {
+            int edge = alive[i];
+            int a = sets.Find(edges[edge].from);
+            int b = sets.Find(edges[edge].to);
+            if (a != b) {
+                offer(a, edge);
+                offer(b, edge);
+            }
+        });
+
+        DynamicArray<DynamicArray<int>> picked(threads);
+        for (int t = 0; t < threads; t++) {
+            picked.Append(DynamicArray<int>());
+        }
+        // roots are read before any merge of this round changes them
+        ParallelForBlocks(0, numNodes, [&](int blockBegin, int blockEnd, int worker) {
+            for (int v = blockBegin; v < blockEnd; v++) {
+                int edge = lightest[v].load(std::memory_order_relaxed);
+                if (edge != -1) {
+                    picked[worker].Append(edge);
+                }
+            }
+        });
+
+        bool merged = false;
+        for (int t = 0; t < threads; t++) {
+            for (int i = 0; i < picked[t].GetLength(); i++) {
+                const auto& edge = edges[picked[t][i]];
+                if (sets.Union(edge.from, edge.to)) {
+                    ForestDetail::AddToForest(graph, edge, forest);
+                    merged = true;
+                }
+            }
+        }
+        if (!merged)
+            break;
+
+        int kept = 0;
+        for (int i = 0; i < alive.GetLength(); i++) {
+            int edge = alive[i];
+            if (sets.Find(edges[edge].from) != sets.Find(edges[edge].to)) {
+                alive[kept++] = edge;
+            }
+        }
+        alive.Truncate(kept);
+    }
+
+    delete[] lightest;
+    return forest;
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+SpanningForest<TKey, WeightType> KruskalSpanningForest(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return KruskalSpanningForest(CsrGraph<TKey, ExactWeights<WeightType>>(graph));
+}
+
+template <typename TKey, typename WeightType, typename Direction>
+SpanningForest<TKey, WeightType> BoruvkaSpanningForest(const Graph<TKey, WeightType, Direction>& graph)
+{
+    return BoruvkaSpanningForest(CsrGraph<TKey, ExactWeights<WeightType>>(graph));
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "CsrGraph.h"
+#include "DynamicArray.h"
+#include "Parallel.h"
+#include <stdexcept>
+
+// Sparse matrix kernels for iterative propagation on a graph (PageRank, personalized PageRank,
+// label spreading). The coefficients of the graph are computed once into contiguous arrays, so an
+// iteration reads no hash tables and decodes no weights:
+//   SparseMatrix m = PullMatrix(csr, [&](int u, int v, double w) { return w / outWeight[u]; });
+//   Multiply(m, x, y);   // y[v] = sum of m(v, u) * x[u] over the in-edges (u, v)
+
+// Row i holds the entries (columns[e], values[e]) for e in [offsets[i], offsets[i + 1]).
+// parts splits the rows into ranges of about equal entry counts, one per thread.
+struct SparseMatrix {
+    DynamicArray<int> offsets;
+    DynamicArray<int> columns;
+    DynamicArray<double> values;
+    DynamicArray<int> parts;
+
+    int GetRowCount() const {
+        return offsets.GetLength() - 1;
+    }
+
+    int GetEntryCount() const {
+        return columns.GetLength();
+    }
+};
+
+// Boundaries of count row ranges with about the same number of entries each; a range always
+// ends at a row boundary, so a row with many entries can make its range longer than the others
+inline DynamicArray<int> BalancedRowRanges(const DynamicArray<int>& offsets, int count)
+{
+    int rows = offsets.GetLength() - 1;
+    if (count < 1) count = 1;
+    DynamicArray<int> bounds(count + 1);
+    bounds.Append(0);
+    long long entries = offsets[rows];
+    for (int p = 1; p < count; p++) {
+        // first row whose entries start at or after the p-th share; entries and rows both weigh one,
+        // so ranges of empty rows are split as well
+        long long target = (entries + rows) * p / count;
+        int low = bounds[p - 1], high = rows;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (offsets[middle] + static_cast<long long>(middle) < target) low = middle + 1;
+            else high = middle;
+        }
+        bounds.Append(low);
+    }
+    bounds.Append(rows);
+    return bounds;
+}
+
+namespace SparseMatrixDetail {
+
+    // forEachEdge(row, add) calls add(column, value) for the entries of row in order
+    template <typename TKey, typename WeightPolicy, typename ForEachEdge>
+    SparseMatrix Collect(const CsrGraph<TKey, WeightPolicy>& graph, ForEachEdge forEachEdge)
+    {
+        int numNodes = graph.GetNodeCount();
+        SparseMatrix matrix;
+        matrix.offsets = DynamicArray<int>(numNodes + 1);
+        matrix.columns = DynamicArray<int>(graph.GetEdgeCount());
+        matrix.values = DynamicArray<double>(graph.GetEdgeCount());
+        matrix.offsets.Append(0);
+        for (int row = 0; row < numNodes; row++) {
+            forEachEdge(row, [&](int column, double value) {
+                matrix.columns.Append(column);
+                matrix.values.Append(value);
+            });
+            matrix.offsets.Append(matrix.columns.GetLength());
+        }
+        matrix.parts = BalancedRowRanges(matrix.offsets, GetThreadCount());
+        return matrix;
+    }
+
+}
+
+// Row v gathers from the in-edges (u, v): entry (v, u) = coefficient(u, v, weight)
+template <typename TKey, typename WeightPolicy, typename Coefficient>
+SparseMatrix PullMatrix(const CsrGraph<TKey, WeightPolicy>& graph, Coefficient coefficient)
+{
+    return SparseMatrixDetail::Collect(graph, [&](int v, auto add) {
+        graph.ForEachInNeighbor(v, [&](int u, typename WeightPolicy::ValueType w) {
+            add(u, coefficient(u, v, static_cast<double>(w)));
+        });
+    });
+}
+
+// Row u scatters along the out-edges (u, v): entry (u, v) = coefficient(u, v, weight)
+template <typename TKey, typename WeightPolicy, typename Coefficient>
+SparseMatrix PushMatrix(const CsrGraph<TKey, WeightPolicy>& graph, Coefficient coefficient)
+{
+    return SparseMatrixDetail::Collect(graph, [&](int u, auto add) {
+        graph.ForEachNeighbor(u, [&](int v, typename WeightPolicy::ValueType w) {
+            add(v, coefficient(u, v, static_cast<double>(w)));
+        });
+    });
+}
+
+// y[i] = sum of values[e] * x[columns[e]] over row i. Each thread owns a range of rows of y,
+// so there is no synchronization; x and y must not overlap.
+inline void Multiply(const SparseMatrix& matrix, const DynamicArray<double>& x, DynamicArray<double>& y)
+{
+    if (x.GetLength() < matrix.GetRowCount() || y.GetLength() < matrix.GetRowCount())
+        throw std::invalid_argument("Multiply: vector shorter than the matrix");
+    const int* offsets = matrix.offsets.data();
+    const int* columns = matrix.columns.data();
+    const double* values = matrix.values.data();
+    const double* in = x.data();
+    double* out = y.data();
+    int partCount = matrix.parts.GetLength() - 1;
+    ParallelForBlocks(0, partCount, [&](int partBegin, int partEnd, int) {
+        for (int row = matrix.parts[partBegin]; row < matrix.parts[partEnd]; row++) {
+            // two independent sums hide the latency of the additions
+            double even = 0.0, odd = 0.0;
+            int e = offsets[row], end = offsets[row + 1];
+            for (; e + 1 < end; e += 2) {
+                even += values[e] * in[columns[e]];
+                odd += values[e + 1] * in[columns[e + 1]];
+            }
+            if (e < end) even += values[e] * in[columns[e]];
+            out[row] = even + odd;
+        }
+    }, 1);
+}
+
+// y[columns[e]] += values[e] * x[i] over every row i, on top of the current y. Rows are scattered
+// by their ranges in parallel into one buffer per worker, which are added to y at the end.
+inline void MultiplyScatter(const SparseMatrix& matrix, const DynamicArray<double>& x, DynamicArray<double>& y)
+{
+    int rows = matrix.GetRowCount();
+    if (x.GetLength() < rows || y.GetLength() < rows)
+        throw std::invalid_argument("MultiplyScatter: vector shorter than the matrix");
+    const int* offsets = matrix.offsets.data();
+    const int* columns = matrix.columns.data();
+    const double* values = matrix.values.data();
+    const double* in = x.data();
+    int size = y.GetLength();
+    int partCount = matrix.parts.GetLength() - 1;
+    int threads = GetThreadCount();
+    DynamicArray<DynamicArray<double>> local(threads);
+    for (int t = 0; t < threads; t++) {
+        local.Append(DynamicArray<double>());
+    }
+    ParallelForBlocks(0, partCount, [&](int partBegin, int partEnd, int worker) {
+        // the first worker scatters straight into y
+        double* out = y.data();
+        if (worker != 0) {
+            if (local[worker].GetLength() == 0) {
+                local[worker].Reserve(size);
+                for (int i = 0; i < size; i++) {
+                    local[worker].Append(0.0);
+                }
+            }
+            out = local[worker].data();
+        }
+        for (int row = matrix.parts[partBegin]; row < matrix.parts[partEnd]; row++) {
+            double value = in[row];
+            for (int e = offsets[row]; e < offsets[row + 1]; e++) {
+                out[columns[e]] += values[e] * value;
+            }
+        }
+    }, 1);
+    for (int t = 1; t < threads; t++) {
+        if (local[t].GetLength() == 0)
+            continue;
+        const double* partial = local[t].data();
+        double* out = y.data();
+        for (int i = 0; i < size; i++) {
+            out[i] += partial[i];
+        }
+    }
+}
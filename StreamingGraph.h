@@ -0,0 +1,333 @@
+#pragma once
+#include "DynamicArray.h"
+#include "GraphComponents.h"
+#include "HashTable.h"
+#include "UnionFind.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Semi-external algorithms: the edges stay in a file and are read in sequential passes,
+// only O(V) state is kept in memory. An edge stream provides
+//   int GetNodeCount() const;  void Rewind();  bool Next(int& from, int& to, Weight& weight);
+// with vertex ids in [0, GetNodeCount()) and names its weight type as EdgeStream::Weight.
+
+// Edges of a file written by Graph::SaveToFile; vertex ids follow the order of the vertex list
+template <typename TKey, typename WeightType = double>
+class TextEdgeStream {
+public:
+    using Weight = WeightType;
+
+private:
+    // a copy: every Rewind reopens the file, long after the caller's string may be gone
+    std::string filename;
+    std::ifstream in;
+    DynamicArray<TKey> Nodes;
+    HashTable<TKey, int> NodeIndex;
+
+    int IndexOf(const TKey& key) const {
+        const int* index = NodeIndex.find(key);
+        if (!index) throw std::runtime_error("TextEdgeStream: edge with an unknown vertex");
+        return *index;
+    }
+
+public:
+    explicit TextEdgeStream(const char* filename) : filename(filename), Nodes(), NodeIndex(11) {
+        Rewind();
+        int nodeCount = 0;
+        in >> nodeCount;
+        Nodes = DynamicArray<TKey>(nodeCount);
+        NodeIndex = HashTable<TKey, int>(nodeCount * 2 + 11);
+        for (int i = 0; i < nodeCount; i++) {
+            TKey vertex;
+            in >> vertex;
+            NodeIndex.insert(vertex, Nodes.GetLength());
+            Nodes.Append(vertex);
+        }
+    }
+
+    int GetNodeCount() const {
+        return Nodes.GetLength();
+    }
+
+    TKey GetVertex(int index) const {
+        return Nodes[index];
+    }
+
+    // Starts a new pass at the first edge
+    void Rewind() {
+        in.close();
+        in.clear();
+        in.open(filename);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open file for loading.");
+        }
+        // the vertex list is skipped after the first read
+        if (Nodes.GetLength() > 0) {
+            int nodeCount = 0;
+            in >> nodeCount;
+            TKey vertex;
+            for (int i = 0; i < nodeCount; i++) {
+                in >> vertex;
+            }
+        }
+    }
+
+    bool Next(int& from, int& to, WeightType& weight) {
+        TKey v1, v2;
+        if (!(in >> v1 >> v2 >> weight))
+            return false;
+        from = IndexOf(v1);
+        to = IndexOf(v2);
+        return true;
+    }
+};
+
+// Binary edge list: an int32 vertex count, then records of int32 from, int32 to and a WeightType
+// weight, all in native byte order. Records are read in blocks.
+template <typename WeightType = double>
+class BinaryEdgeStream {
+public:
+    using Weight = WeightType;
+
+private:
+    static constexpr int RecordSize = 2 * sizeof(int32_t) + sizeof(WeightType);
+    static constexpr int BlockRecords = 4096;
+
+    std::string filename;
+    std::ifstream in;
+    int nodeCount;
+    char* block;
+    int blockRecords;
+    int position;
+
+public:
+    explicit BinaryEdgeStream(const char* filename)
+        : filename(filename), nodeCount(0), block(new char[RecordSize * BlockRecords]),
+          blockRecords(0), position(0) {
+        Rewind();
+    }
+
+    BinaryEdgeStream(const BinaryEdgeStream&) = delete;
+    BinaryEdgeStream& operator=(const BinaryEdgeStream&) = delete;
+
+    ~BinaryEdgeStream() {
+        delete[] block;
+    }
+
+    int GetNodeCount() const {
+        return nodeCount;
+    }
+
+    // The vertices of a binary edge list are their ids
+    int GetVertex(int index) const {
+        return index;
+    }
+
+    void Rewind() {
+        in.close();
+        in.clear();
+        in.open(filename, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open file for loading.");
+        }
+        int32_t count = 0;
+        if (!in.read(reinterpret_cast<char*>(&count), sizeof(count)) || count < 0) {
+            throw std::runtime_error("BinaryEdgeStream: bad header");
+        }
+        nodeCount = count;
+        blockRecords = 0;
+        position = 0;
+    }
+
+    bool Next(int& from, int& to, WeightType& weight) {
+        if (position == blockRecords) {
+            in.read(block, RecordSize * BlockRecords);
+            blockRecords = static_cast<int>(in.gcount() / RecordSize);
+            position = 0;
+            if (blockRecords == 0)
+                return false;
+        }
+        const char* record = block + position * RecordSize;
+        int32_t ids[2];
+        std::memcpy(ids, record, sizeof(ids));
+        std::memcpy(&weight, record + sizeof(ids), sizeof(WeightType));
+        position++;
+        if (ids[0] < 0 || ids[0] >= nodeCount || ids[1] < 0 || ids[1] >= nodeCount)
+            throw std::runtime_error("BinaryEdgeStream: vertex id out of range");
+        from = ids[0];
+        to = ids[1];
+        return true;
+    }
+};
+
+// Writes the edges of a stream as a binary edge list in one pass
+template <typename EdgeStream>
+void WriteBinaryEdgeList(EdgeStream& stream, const char* filename)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for saving.");
+    }
+    int32_t count = stream.GetNodeCount();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    stream.Rewind();
+    int from, to;
+    typename EdgeStream::Weight weight;
+    while (stream.Next(from, to, weight)) {
+        int32_t ids[2] = { from, to };
+        out.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+        out.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+    }
+}
+
+struct DegreeStatistics {
+    DynamicArray<int> outDegree;
+    DynamicArray<int> inDegree;
+    long long edgeCount = 0;
+    // largest outDegree + inDegree, the degree in the undirected sense
+    int maxDegree = 0;
+};
+
+// One pass: per-vertex degrees and the edge count
+template <typename EdgeStream>
+DegreeStatistics StreamingDegrees(EdgeStream& stream)
+{
+    int numNodes = stream.GetNodeCount();
+    DegreeStatistics result;
+    result.outDegree = DynamicArray<int>(numNodes);
+    result.inDegree = DynamicArray<int>(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        result.outDegree.Append(0);
+        result.inDegree.Append(0);
+    }
+    stream.Rewind();
+    int from, to;
+    typename EdgeStream::Weight weight;
+    while (stream.Next(from, to, weight)) {
+        result.outDegree[from]++;
+        result.inDegree[to]++;
+        result.edgeCount++;
+    }
+    for (int v = 0; v < numNodes; v++) {
+        int degree = result.outDegree[v] + result.inDegree[v];
+        if (degree > result.maxDegree) result.maxDegree = degree;
+    }
+    return result;
+}
+
+// One pass of union-find over the edges; components are weakly connected for directed files
+template <typename EdgeStream>
+ComponentsResult StreamingComponents(EdgeStream& stream)
+{
+    int numNodes = stream.GetNodeCount();
+    UnionFind sets(numNodes);
+    stream.Rewind();
+    int from, to;
+    typename EdgeStream::Weight weight;
+    while (stream.Next(from, to, weight)) {
+        sets.Union(from, to);
+    }
+
+    ComponentsResult result;
+    result.component = DynamicArray<int>(numNodes);
+    DynamicArray<int> labelOfRoot(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        labelOfRoot.Append(-1);
+    }
+    for (int v = 0; v < numNodes; v++) {
+        int root = sets.Find(v);
+        if (labelOfRoot[root] == -1) {
+            labelOfRoot[root] = result.sizes.GetLength();
+            result.sizes.Append(0);
+        }
+        result.component.Append(labelOfRoot[root]);
+        result.sizes[labelOfRoot[root]]++;
+    }
+    return result;
+}
+
+namespace StreamingDetail {
+
+    // Pseudo-random priority of a vertex; a fixed order by id would need one pass per vertex on a path
+    inline uint32_t Priority(int v) {
+        uint32_t x = static_cast<uint32_t>(v) + 0x9E3779B9u;
+        x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+        x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+        return x ^ (x >> 16);
+    }
+
+    inline bool Precedes(int a, int b) {
+        uint32_t pa = Priority(a), pb = Priority(b);
+        return pa < pb || (pa == pb && a < b);
+    }
+
+}
+
+// Greedy coloring in passes (Jones-Plassmann order). Every pass marks the colors of colored
+// neighbors in a 64-color window bitmap per vertex and blocks each uncolored vertex that has an
+// uncolored neighbor of higher priority; the unblocked vertices form an independent set and take
+// their smallest free color. A vertex whose window is full moves it up by 64 colors.
+// passes, if given, receives the number of passes over the file.
+template <typename EdgeStream>
+DynamicArray<int> StreamingColoring(EdgeStream& stream, int* passes = nullptr)
+{
+    int numNodes = stream.GetNodeCount();
+    DynamicArray<int> colors(numNodes);
+    DynamicArray<uint64_t> forbidden(numNodes);
+    DynamicArray<int> windowBase(numNodes);
+    DynamicArray<bool> blocked(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        colors.Append(-1);
+        forbidden.Append(0);
+        windowBase.Append(0);
+        blocked.Append(false);
+    }
+
+    int uncolored = numNodes;
+    int passCount = 0;
+    while (uncolored > 0) {
+        passCount++;
+        for (int v = 0; v < numNodes; v++) {
+            blocked[v] = false;
+        }
+        stream.Rewind();
+        int from, to;
+        typename EdgeStream::Weight weight;
+        while (stream.Next(from, to, weight)) {
+            if (from == to)
+                continue;
+            int cf = colors[from], ct = colors[to];
+            if (cf == -1 && ct == -1) {
+                blocked[StreamingDetail::Precedes(from, to) ? to : from] = true;
+            }
+            else if (cf == -1) {
+                int bit = ct - windowBase[from];
+                if (bit >= 0 && bit < 64) forbidden[from] |= uint64_t(1) << bit;
+            }
+            else if (ct == -1) {
+                int bit = cf - windowBase[to];
+                if (bit >= 0 && bit < 64) forbidden[to] |= uint64_t(1) << bit;
+            }
+        }
+
+        for (int v = 0; v < numNodes; v++) {
+            if (colors[v] != -1 || blocked[v])
+                continue;
+            if (forbidden[v] == ~uint64_t(0)) {
+                // every color of the window is taken; the next pass collects the next window
+                windowBase[v] += 64;
+                forbidden[v] = 0;
+                continue;
+            }
+            int bit = 0;
+            while (forbidden[v] & (uint64_t(1) << bit)) bit++;
+            colors[v] = windowBase[v] + bit;
+            uncolored--;
+        }
+    }
+    if (passes) *passes = passCount;
+    return colors;
+}
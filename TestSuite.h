@@ -1,7 +1,30 @@
 #pragma once
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include "GraphUtils.h"
+#include "GraphTraversal.h"
+#include "GraphComponents.h"
+#include "SpanningForest.h"
+#include "ShortestPaths.h"
+#include "BoundedSearch.h"
+#include "VertexOrdering.h"
+#include "CompressedGraph.h"
+#include "StreamingGraph.h"
+#include "MutationLog.h"
+#include "GraphViews.h"
+#include "ArrayView.h"
+#include "Triangles.h"
+#include "Centrality.h"
+#include "PageRank.h"
+#include "DynamicColoring.h"
+#include "ParallelColoring.h"
+#include "ShortestPathCache.h"
 
 inline void RunAllTests()
 {
@@ -10,6 +33,21 @@ inline void RunAllTests()
 
     cout << "\nRunning tests...\n";
 
+    {
+        // probe steps must reach every slot: with capacity 4 and step 2 the third even key found no slot
+        HashTable<int, int> small(4, 0.9);
+        small.insert(0, 0);
+        small.insert(4, 1);
+        small.insert(8, 2);
+        assert(small.size() == 3 && small.get(0) == 0 && small.get(4) == 1 && small.get(8) == 2);
+        // keys sharing a factor with the old 11 * 2^k capacities, through several rehashes
+        HashTable<int, int> grown;
+        for (int i = 0; i < 20000; i++) grown.insert(i * 88, i);
+        for (int i = 0; i < 20000; i++) assert(grown.get(i * 88) == i);
+        for (int n = grown.getCapacity(), d = 2; d * d <= n; d++) assert(n % d != 0);
+        cout << "Test: hash table probing reaches every slot -> Passed.\n";
+    }
+
     {
         Graph<int, double> g;
         assert(g.GetNodeCount() == 0);
@@ -217,5 +255,1573 @@ inline void RunAllTests()
         std::cout << "Test: distances string with detailed path checks -> Passed.\n";
     }
 
+    {
+        Graph<int, double> g;
+        for (int i = 0; i < 6; i++) g.InsertVertex(i * 10);
+        g.ConnectNodes(0, 10, 2.0);
+        g.ConnectNodes(10, 20, 3.0);
+        g.ConnectNodes(20, 30, 4.0);
+        g.ConnectNodes(0, 30, 20.0);
+        g.ConnectNodes(30, 40, 1.0);
+
+        CsrGraph<int> exact(g);
+        assert(exact.GetNodeCount() == 6);
+        assert(exact.GetEdgeCount() == 10);
+        assert(exact.FindNodeIndex(30) == 3 && exact.FindNodeIndex(7) == -1);
+        assert(exact.GetDegree(3) == 3 && exact.GetDegree(5) == 0);
+        for (int i = 0; i < exact.GetNodeCount(); i++) {
+            auto edges = g.GetAdjacentVertices(g.GetVertex(i));
+            assert(edges.GetLength() == exact.GetDegree(i));
+            for (int e = 0; e < edges.GetLength(); e++) {
+                int k = exact.RowBegin(i) + e;
+                assert(exact.GetVertex(exact.GetTarget(k)) == edges[e].GetNode());
+                assert(exact.GetWeight(k) == edges[e].GetWeight());
+            }
+        }
+
+        auto dGraph = MinDistances(g, 0);
+        auto dCsr = MinDistances(exact, 0);
+        auto cGraph = GraphColoring(g);
+        auto cCsr = GraphColoring(exact);
+        for (int i = 0; i < 6; i++) {
+            assert(dGraph[i].distance == dCsr[i].distance);
+            assert(dGraph[i].path.GetLength() == dCsr[i].path.GetLength());
+            assert(cGraph[i] == cCsr[i]);
+        }
+        assert(dCsr[4].distance == 10 && dCsr[5].distance == -1);
+
+        CsrGraph<int, FloatWeights> narrow(g);
+        CsrGraph<int, QuantizedWeights> quantized(g);
+        for (int k = 0; k < exact.GetEdgeCount(); k++) {
+            assert(narrow.GetWeight(k) == static_cast<float>(exact.GetWeight(k)));
+            assert(std::fabs(quantized.GetWeight(k) - exact.GetWeight(k)) < 1e-3);
+        }
+        assert(quantized.MemoryUsage() < narrow.MemoryUsage());
+        assert(narrow.MemoryUsage() < exact.MemoryUsage());
+        cout << "Test: CSR snapshot with narrow weights -> Passed.\n";
+    }
+
+    {
+        Graph<int, double, Directed> g;
+        for (int i = 1; i <= 4; i++) g.InsertVertex(i);
+        g.ConnectNodes(1, 2, 1.0);
+        g.ConnectNodes(2, 3, 2.0);
+        g.ConnectNodes(3, 1, 4.0);
+        g.ConnectNodes(3, 4, 1.0);
+        assert(g.GetAdjacentVertices(1).GetLength() == 1);
+        assert(g.GetIncomingVertices(1).GetLength() == 1);
+        assert(g.GetIncomingVertices(1)[0].GetNode() == 3);
+        assert(g.GetDegree(3) == 2 && g.GetInDegree(3) == 1 && g.GetInDegree(4) == 1 && g.GetDegree(99) == 0);
+
+        auto d = MinDistances(g, 2);
+        assert(d[g.FindNodeIndex(3)].distance == 2);
+        assert(d[g.FindNodeIndex(1)].distance == 6);
+        assert(d[g.FindNodeIndex(4)].distance == 3);
+        auto back = MinDistances(g, 4);
+        assert(back[g.FindNodeIndex(1)].distance == -1);
+
+        auto c = GraphColoring(g);
+        CsrGraph<int> csr(g);
+        auto cCsr = GraphColoring(csr);
+        assert(csr.GetEdgeCount() == 4 && csr.GetInDegree(csr.FindNodeIndex(1)) == 1);
+        for (int i = 0; i < c.GetLength(); i++) {
+            assert(c[i] == cCsr[i]);
+        }
+        assert(c[0] != c[1] && c[1] != c[2] && c[0] != c[2]);
+
+        g.SaveToFile("directed_test.tmp");
+        Graph<int, double, Directed> loaded;
+        loaded.LoadFromFile("directed_test.tmp");
+        std::remove("directed_test.tmp");
+        assert(loaded.GetAdjacentVertices(3).GetLength() == 2);
+        assert(loaded.GetAdjacentVertices(4).GetLength() == 0);
+
+        g.DisconnectNodes(3, 1);
+        assert(g.GetIncomingVertices(1).GetLength() == 0);
+        assert(g.GetAdjacentVertices(3).GetLength() == 1);
+        g.EraseVertex(2);
+        assert(g.GetAdjacentVertices(1).GetLength() == 0);
+        assert(g.GetIncomingVertices(3).GetLength() == 0);
+        cout << "Test: directed graph -> Passed.\n";
+    }
+
+    {
+        Graph<int, double> g;
+        for (int i = 0; i < 3; i++) g.InsertVertex(i);
+        g.ConnectNodes(0, 1, 1.0);
+        g.ConnectNodes(2, 1, 2.0);
+        g.SaveToFile("undirected_test.tmp");
+        int lines = 0;
+        {
+            std::ifstream in("undirected_test.tmp");
+            std::string line;
+            while (std::getline(in, line)) lines++;
+        }
+        Graph<int, double> loaded;
+        loaded.LoadFromFile("undirected_test.tmp");
+        std::remove("undirected_test.tmp");
+        assert(lines == 1 + 3 + 2);
+        assert(loaded.GetAdjacentVertices(1).GetLength() == 2);
+        assert(loaded.GetAdjacentVertices(2).GetLength() == 1);
+        cout << "Test: undirected edges saved once -> Passed.\n";
+    }
+
+    {
+        Graph<int, double> g;
+        for (int i = 0; i < 8; i++) g.InsertVertex(i);
+        for (int i = 0; i < 8; i++) g.ConnectNodes(i, (i + 1) % 8, 1.0);
+        g.ConnectNodes(0, 4, 1.0);
+        g.ConnectNodes(2, 2, 1.0);
+
+        g.EraseVertex(2);
+        assert(g.GetNodeCount() == 7 && !g.HasVertex(2) && g.FindNodeIndex(2) == -1);
+        assert(g.GetAdjacentVertices(1).GetLength() == 1 && g.GetAdjacentVertices(3).GetLength() == 1);
+
+        DynamicArray<int> batch;
+        batch.Append(4);
+        batch.Append(6);
+        batch.Append(4);
+        batch.Append(100);
+        g.EraseVertices(batch);
+        assert(g.GetNodeCount() == 5);
+        for (int i = 0; i < g.GetNodeCount(); i++) {
+            int v = g.GetVertex(i);
+            assert(g.FindNodeIndex(v) == i);
+            auto edges = g.GetAdjacentVertices(v);
+            for (int e = 0; e < edges.GetLength(); e++) {
+                assert(g.HasVertex(edges[e].GetNode()));
+            }
+        }
+        assert(g.GetAdjacentVertices(0).GetLength() == 2);
+        assert(g.GetAdjacentVertices(5).GetLength() == 0);
+        assert(g.GetAdjacentVertices(7).GetLength() == 1);
+
+        Graph<int, double, Directed> dg;
+        for (int i = 0; i < 4; i++) dg.InsertVertex(i);
+        dg.ConnectNodes(0, 1, 1.0);
+        dg.ConnectNodes(1, 2, 1.0);
+        dg.ConnectNodes(3, 1, 1.0);
+        DynamicArray<int> directedBatch;
+        directedBatch.Append(1);
+        dg.EraseVertices(directedBatch);
+        assert(dg.GetAdjacentVertices(0).GetLength() == 0 && dg.GetAdjacentVertices(3).GetLength() == 0);
+        assert(dg.GetIncomingVertices(2).GetLength() == 0);
+        cout << "Test: vertex erase and batch erase -> Passed.\n";
+    }
+
+    {
+        Graph<int, double> g;
+        for (int i = 0; i <= 200; i++) g.InsertVertex(i);
+        for (int i = 1; i <= 200; i++) g.ConnectNodes(0, i, static_cast<double>(i));
+        g.ConnectNodes(0, 5, 99.0);
+        assert(g.GetAdjacentVertices(0).GetLength() == 200);
+        assert(g.HasEdge(0, 150) && g.HasEdge(150, 0) && !g.HasEdge(1, 2));
+        assert(g.GetEdgeWeight(0, 5) == 5.0 && g.GetEdgeWeight(77, 0) == 77.0);
+        bool thrown = false;
+        try { g.GetEdgeWeight(1, 2); }
+        catch (const std::runtime_error&) { thrown = true; }
+        assert(thrown);
+
+        for (int i = 1; i <= 200; i += 2) g.DisconnectNodes(i, 0);
+        g.EraseVertex(100);
+        DynamicArray<int> batch;
+        for (int i = 2; i <= 60; i += 2) batch.Append(i);
+        g.EraseVertices(batch);
+        auto hubEdges = g.GetAdjacentVertices(0);
+        assert(hubEdges.GetLength() == 69);
+        for (int e = 0; e < hubEdges.GetLength(); e++) {
+            int v = hubEdges[e].GetNode();
+            assert(v % 2 == 0 && v > 60 && v != 100);
+            assert(g.GetEdgeWeight(0, v) == static_cast<double>(v));
+        }
+        for (int i = 1; i <= 200; i++) {
+            assert(g.HasEdge(0, i) == (i % 2 == 0 && i > 60 && i != 100));
+        }
+        cout << "Test: hub edge lookups -> Passed.\n";
+    }
+
+    {
+        unsigned int seed = 12345;
+        auto next = [&seed](int bound) {
+            seed = seed * 1103515245u + 12345u;
+            return static_cast<int>((seed >> 16) % bound);
+        };
+        Graph<int, double> g;
+        Graph<int, double, Directed> dg;
+        for (int i = 0; i < 30; i++) {
+            g.InsertVertex(i);
+            dg.InsertVertex(i);
+        }
+        for (int i = 0; i < 60; i++) {
+            int a = next(30), b = next(30);
+            g.ConnectNodes(a, b, 1.0 + next(9));
+            dg.ConnectNodes(a, b, 1.0 + next(9));
+        }
+        ShortestPathCache<int, double> cache(g);
+        ShortestPathCache<int, double, Directed> directedCache(dg);
+        auto checkSource = [](auto& graph, auto& pathCache, int source) {
+            auto expected = MinDistances(graph, source);
+            auto cached = pathCache.GetMinDistances(source);
+            for (int i = 0; i < expected.GetLength(); i++) {
+                assert(expected[i].distance == cached[i].distance);
+                if (cached[i].distance > 0) {
+                    assert(cached[i].path[0] == source && cached[i].path.GetLength() > 1);
+                }
+            }
+        };
+        for (int step = 0; step < 200; step++) {
+            int a = next(30), b = next(30);
+            int kind = next(3);
+            if (kind == 0) {
+                cache.ConnectNodes(a, b, 1.0 + next(9));
+                directedCache.ConnectNodes(a, b, 1.0 + next(9));
+            }
+            else if (kind == 1) {
+                cache.DisconnectNodes(a, b);
+                directedCache.DisconnectNodes(a, b);
+            }
+            else {
+                if (g.HasEdge(a, b)) cache.SetEdgeWeight(a, b, 1.0 + next(9));
+                if (dg.HasEdge(a, b)) directedCache.SetEdgeWeight(a, b, 1.0 + next(9));
+            }
+            checkSource(g, cache, 0);
+            checkSource(g, cache, 7);
+            checkSource(dg, directedCache, 3);
+        }
+        unsigned long long version = g.GetVersion();
+        g.EraseVertex(7);
+        assert(g.GetVersion() != version);
+        checkSource(g, cache, 0);
+        assert(cache.GetDistance(0, 0) == 0 && cache.GetDistance(0, 7) == -1);
+        cache.Forget(0);
+        assert(!cache.IsCached(0) && cache.IsCached(7));
+        cout << "Test: incremental shortest-path cache -> Passed.\n";
+    }
+
+    {
+        unsigned int seed = 777;
+        auto next = [&seed](int bound) {
+            seed = seed * 1103515245u + 12345u;
+            return static_cast<int>((seed >> 16) % bound);
+        };
+        Graph<int, double> g;
+        for (int i = 0; i < 40; i++) g.InsertVertex(i);
+        DynamicColoring<int, double> coloring(g);
+        auto checkColoring = [&g, &coloring]() {
+            const auto& colors = coloring.GetColors();
+            assert(colors.GetLength() == g.GetNodeCount());
+            for (int i = 0; i < g.GetNodeCount(); i++) {
+                assert(colors[i] >= 0);
+                auto edges = g.GetAdjacentVertices(g.GetVertex(i));
+                for (int e = 0; e < edges.GetLength(); e++) {
+                    int j = g.FindNodeIndex(edges[e].GetNode());
+                    assert(i == j || colors[i] != colors[j]);
+                }
+            }
+        };
+        assert(coloring.GetColorCount() == 1);
+        for (int step = 0; step < 300; step++) {
+            int a = next(40), b = next(40);
+            int kind = next(10);
+            if (kind < 7) coloring.ConnectNodes(a, b, 1.0);
+            else if (kind < 9) coloring.DisconnectNodes(a, b);
+            else if (g.HasVertex(a)) {
+                coloring.EraseVertex(a);
+                coloring.InsertVertex(a);
+            }
+            checkColoring();
+        }
+        g.ConnectNodes(g.GetVertex(0), g.GetVertex(1), 1.0);
+        checkColoring();
+        cout << "Test: incremental coloring -> Passed.\n";
+    }
+
+    {
+        SetThreadCount(4);
+        Graph<int, double> g;
+        g.GenerateGraph(3000, 30000, 1.0, 1.0);
+        for (int i = 3000; i < 3100; i++) {
+            g.InsertVertex(i);
+            g.ConnectNodes(i - 1, i, 1.0);
+        }
+        g.InsertVertex(5000);
+        Graph<int, double, Directed> dg;
+        for (int i = 0; i < 2000; i++) dg.InsertVertex(i);
+        for (int i = 0; i < 20000; i++) dg.ConnectNodes(std::rand() % 2000, std::rand() % 2000, 1.0);
+
+        auto checkBfs = [](const auto& csr, int source) {
+            int n = csr.GetNodeCount();
+            DynamicArray<int> expected;
+            for (int i = 0; i < n; i++) expected.Append(-1);
+            DynamicArray<int> queue;
+            expected[source] = 0;
+            queue.Append(source);
+            for (int head = 0; head < queue.GetLength(); head++) {
+                int u = queue[head];
+                for (int e = csr.RowBegin(u); e < csr.RowEnd(u); e++) {
+                    int v = csr.GetTarget(e);
+                    if (expected[v] == -1) {
+                        expected[v] = expected[u] + 1;
+                        queue.Append(v);
+                    }
+                }
+            }
+
+            BfsResult result = BreadthFirstSearch(csr, source);
+            for (int v = 0; v < n; v++) {
+                assert(result.distance[v] == expected[v]);
+                if (v == source || expected[v] == -1) {
+                    assert(result.parent[v] == -1);
+                    continue;
+                }
+                int p = result.parent[v];
+                assert(result.distance[p] == result.distance[v] - 1);
+                bool adjacent = false;
+                for (int e = csr.RowBegin(p); e < csr.RowEnd(p); e++) {
+                    if (csr.GetTarget(e) == v) adjacent = true;
+                }
+                assert(adjacent);
+            }
+
+            int visitedCount = 0;
+            DynamicArray<bool> seen;
+            for (int i = 0; i < n; i++) seen.Append(false);
+            for (DepthFirstIterator<int, ExactWeights<double>> it(csr, source); !it.IsEnd(); ++it) {
+                assert(!seen[*it] && expected[*it] != -1);
+                assert(it.GetDepth() >= expected[*it]);
+                seen[*it] = true;
+                visitedCount++;
+            }
+            int reachable = 0;
+            for (int i = 0; i < n; i++) {
+                if (expected[i] != -1) reachable++;
+            }
+            assert(visitedCount == reachable);
+        };
+
+        CsrGraph<int> csr(g);
+        checkBfs(csr, 0);
+        checkBfs(csr, csr.FindNodeIndex(3099));
+        checkBfs(csr, csr.FindNodeIndex(5000));
+        CsrGraph<int> directedCsr(dg);
+        checkBfs(directedCsr, 0);
+        checkBfs(directedCsr, 1999);
+
+        BfsResult byKey = BreadthFirstSearch(g, 3050);
+        assert(byKey.distance[g.FindNodeIndex(3051)] == 1);
+        assert(byKey.distance[g.FindNodeIndex(5000)] == -1);
+        SetThreadCount(0);
+        cout << "Test: direction-optimizing BFS and DFS iterator -> Passed.\n";
+    }
+
+    {
+        SetThreadCount(4);
+        auto checkComponents = [](const auto& csr) {
+            int n = csr.GetNodeCount();
+            ComponentsResult result = ConnectedComponents(csr);
+            DynamicArray<int> expected;
+            for (int i = 0; i < n; i++) expected.Append(-1);
+            int count = 0;
+            for (int s = 0; s < n; s++) {
+                if (expected[s] != -1) continue;
+                DynamicArray<int> queue;
+                queue.Append(s);
+                expected[s] = count;
+                for (int head = 0; head < queue.GetLength(); head++) {
+                    int u = queue[head];
+                    for (int e = csr.RowBegin(u); e < csr.RowEnd(u); e++) {
+                        int v = csr.GetTarget(e);
+                        if (expected[v] == -1) { expected[v] = count; queue.Append(v); }
+                    }
+                    for (int e = csr.InRowBegin(u); e < csr.InRowEnd(u); e++) {
+                        int v = csr.GetSource(e);
+                        if (expected[v] == -1) { expected[v] = count; queue.Append(v); }
+                    }
+                }
+                count++;
+            }
+            assert(result.GetCount() == count);
+            int total = 0;
+            for (int c = 0; c < result.GetCount(); c++) total += result.sizes[c];
+            assert(total == n);
+            // the labels must induce the same partition as the reference labels
+            DynamicArray<int> mapping;
+            for (int i = 0; i < count; i++) mapping.Append(-1);
+            for (int v = 0; v < n; v++) {
+                if (mapping[expected[v]] == -1) mapping[expected[v]] = result.component[v];
+                assert(mapping[expected[v]] == result.component[v]);
+            }
+        };
+
+        Graph<int, double> g;
+        g.GenerateGraph(4000, 3000, 1.0, 1.0);
+        checkComponents(CsrGraph<int>(g));
+        g.GenerateGraph(4000, 12000, 1.0, 1.0);
+        checkComponents(CsrGraph<int>(g));
+        Graph<int, double, Directed> dg;
+        for (int i = 0; i < 3000; i++) dg.InsertVertex(i);
+        for (int i = 0; i < 2500; i++) dg.ConnectNodes(std::rand() % 3000, std::rand() % 3000, 1.0);
+        checkComponents(CsrGraph<int>(dg));
+
+        Graph<int, double> small;
+        for (int i = 0; i < 5; i++) small.InsertVertex(i);
+        small.ConnectNodes(0, 1, 1.0);
+        small.ConnectNodes(3, 4, 1.0);
+        ComponentsResult components = ConnectedComponents(small);
+        assert(components.GetCount() == 3);
+        assert(components.component[0] == components.component[1]);
+        assert(components.component[3] == components.component[4]);
+        assert(components.sizes[components.component[2]] == 1);
+        SetThreadCount(0);
+        cout << "Test: connected components -> Passed.\n";
+    }
+
+    {
+        Graph<std::string, double> g;
+        g.InsertVertex("A");
+        g.InsertVertex("B");
+        g.InsertVertex("C");
+        g.InsertVertex("D");
+        g.InsertVertex("E");
+        g.InsertVertex("F");
+        g.ConnectNodes("A", "B", 4.0);
+        g.ConnectNodes("A", "C", 1.0);
+        g.ConnectNodes("B", "C", 2.0);
+        g.ConnectNodes("C", "D", 5.0);
+        g.ConnectNodes("B", "D", 8.0);
+        g.ConnectNodes("E", "F", 3.0);
+        auto kruskal = KruskalSpanningForest(g);
+        auto boruvka = BoruvkaSpanningForest(g);
+        assert(kruskal.totalWeight == 11.0 && kruskal.edges.GetLength() == 4);
+        assert(boruvka.totalWeight == 11.0 && boruvka.edges.GetLength() == 4);
+
+        SetThreadCount(4);
+        Graph<int, double> big;
+        big.GenerateGraph(3000, 9000, 1.0, 100.0);
+        CsrGraph<int> csr(big);
+        auto k = KruskalSpanningForest(csr);
+        auto b = BoruvkaSpanningForest(csr);
+        ComponentsResult components = ConnectedComponents(csr);
+        assert(k.edges.GetLength() == 3000 - components.GetCount());
+        assert(b.edges.GetLength() == k.edges.GetLength());
+        assert(std::fabs(k.totalWeight - b.totalWeight) < 1e-6);
+        UnionFind check(3000);
+        for (int i = 0; i < b.edges.GetLength(); i++) {
+            assert(big.GetEdgeWeight(b.edges[i].from, b.edges[i].to) == b.edges[i].weight);
+            assert(check.Union(b.edges[i].from, b.edges[i].to));
+        }
+        SetThreadCount(0);
+        cout << "Test: minimum spanning forest -> Passed.\n";
+    }
+
+    {
+        SetThreadCount(4);
+        Graph<int, double> g;
+        g.GenerateGraph(2000, 8000, 1.0, 50.0);
+        Graph<int, double, Directed> dg;
+        for (int i = 0; i < 1500; i++) dg.InsertVertex(i);
+        for (int i = 0; i < 6000; i++) dg.ConnectNodes(std::rand() % 1500, std::rand() % 1500, 1.0 + std::rand() % 30);
+        dg.ConnectNodes(0, 1, 0.5);
+        dg.ConnectNodes(1, 0, 0.5);
+
+        auto checkDeltaStepping = [](const auto& graph, int source, int delta) {
+            auto expected = MinDistances(graph, graph.GetVertex(source));
+            auto actual = DeltaSteppingMinDistances(graph, graph.GetVertex(source), delta);
+            for (int i = 0; i < expected.GetLength(); i++) {
+                assert(expected[i].distance == actual[i].distance);
+                if (actual[i].distance > 0) {
+                    int length = actual[i].path.GetLength();
+                    int sum = 0;
+                    for (int j = 1; j < length; j++) {
+                        sum += static_cast<int>(graph.GetEdgeWeight(actual[i].path[j - 1], actual[i].path[j]));
+                    }
+                    assert(sum == actual[i].distance && actual[i].path[length - 1] == graph.GetVertex(i));
+                }
+            }
+        };
+        checkDeltaStepping(g, 0, 0);
+        checkDeltaStepping(g, 17, 1);
+        checkDeltaStepping(g, 5, 1000);
+        checkDeltaStepping(dg, 0, 0);
+        checkDeltaStepping(dg, 3, 7);
+        // a negative weight is rejected instead of wrapping around in the unsigned distances
+        Graph<int, double> negative;
+        for (int v = 1; v <= 4; v++) negative.InsertVertex(v);
+        negative.ConnectNodes(1, 2, 5.0);
+        negative.ConnectNodes(2, 3, -1.0);
+        negative.ConnectNodes(3, 4, 2.0);
+        bool graphThrown = false, csrThrown = false;
+        try { DeltaSteppingMinDistances(negative, 1); }
+        catch (const std::invalid_argument&) { graphThrown = true; }
+        try { DeltaSteppingDistances(CsrGraph<int>(negative), 0, 2); }
+        catch (const std::invalid_argument&) { csrThrown = true; }
+        assert(graphThrown && csrThrown);
+        SetThreadCount(0);
+        cout << "Test: delta-stepping shortest paths -> Passed.\n";
+    }
+
+    {
+        // the same integer weights as double (general path) and as int (Dial, or the heap for large weights)
+        auto checkIntegerWeights = [](auto& real, auto& integer, int maxWeight) {
+            unsigned int seed = 2024u;
+            for (int i = 0; i < 800; i++) {
+                real.InsertVertex(i);
+                integer.InsertVertex(i);
+            }
+            for (int i = 0; i < 3000; i++) {
+                seed = seed * 1103515245u + 12345u;
+                int from = (seed >> 8) % 800;
+                seed = seed * 1103515245u + 12345u;
+                int to = (seed >> 8) % 800;
+                seed = seed * 1103515245u + 12345u;
+                int weight = static_cast<int>((seed >> 8) % (maxWeight + 1));
+                real.ConnectNodes(from, to, weight);
+                integer.ConnectNodes(from, to, weight);
+            }
+            for (int source = 0; source < 800; source += 199) {
+                auto expected = MinDistances(real, source);
+                auto actual = MinDistances(integer, source);
+                auto fromCsr = MinDistances(CsrGraph<int, ExactWeights<int>>(integer), source);
+                for (int i = 0; i < 800; i++) {
+                    assert(expected[i].distance == actual[i].distance && fromCsr[i].distance == actual[i].distance);
+                    if (actual[i].distance >= 0) {
+                        int length = actual[i].path.GetLength();
+                        int sum = 0;
+                        for (int j = 1; j < length; j++) {
+                            sum += integer.GetEdgeWeight(actual[i].path[j - 1], actual[i].path[j]);
+                        }
+                        assert(actual[i].path[0] == source && actual[i].path[length - 1] == i && sum == actual[i].distance);
+                    }
+                }
+            }
+        };
+        Graph<int, double> real;
+        Graph<int, int> integer;
+        checkIntegerWeights(real, integer, 20);
+        Graph<int, double, Directed> directedReal;
+        Graph<int, int, Directed> directedInteger;
+        checkIntegerWeights(directedReal, directedInteger, 20);
+        Graph<int, double> wideReal;
+        Graph<int, int> wideInteger;
+        checkIntegerWeights(wideReal, wideInteger, 1000000);
+        assert(!FitsDial(CsrGraph<int, ExactWeights<int>>(wideInteger)));
+        // a negative edge takes the heap fallback, which rejects it instead of relaxing around the cycle
+        Graph<int, int> negative;
+        for (int v = 1; v <= 3; v++) negative.InsertVertex(v);
+        negative.ConnectNodes(1, 2, 3);
+        negative.ConnectNodes(2, 3, -1);
+        bool negativeThrown = false;
+        try { MinDistances(negative, 1); }
+        catch (const std::invalid_argument&) { negativeThrown = true; }
+        assert(negativeThrown);
+        // the floating-point paths and the views reject it as well
+        Graph<int, double> negativeReal;
+        for (int v = 1; v <= 3; v++) negativeReal.InsertVertex(v);
+        negativeReal.ConnectNodes(1, 2, 3.0);
+        negativeReal.ConnectNodes(2, 3, -1.0);
+        int rejected = 0;
+        try { MinDistances(negativeReal, 1); }
+        catch (const std::invalid_argument&) { rejected++; }
+        try { MinDistances(CsrGraph<int>(negativeReal), 1); }
+        catch (const std::invalid_argument&) { rejected++; }
+        try { MinDistances(ViewOf(negativeReal), 1); }
+        catch (const std::invalid_argument&) { rejected++; }
+        assert(rejected == 3);
+        cout << "Test: integer-weight shortest paths -> Passed.\n";
+    }
+
+    {
+        Graph<int, double, Directed> g;
+        g.GenerateGraph(1000, 4000, 1.0, 20.0);
+        CsrGraph<int> csr(g);
+        BoundedSearch<int, ExactWeights<double>> search(csr);
+        assert(search.GetDistance(0) == -1);
+        // one searcher serves all queries, so stale scratch from earlier queries is exercised
+        for (int source = 0; source < 1000; source += 97) {
+            auto all = MinDistances(csr, csr.GetVertex(source));
+            for (int radius = 0; radius <= 40; radius += 20) {
+                const auto& near = search.WithinRadius(source, radius);
+                int expectedCount = 0;
+                for (int v = 0; v < 1000; v++) {
+                    if (all[v].distance != -1 && all[v].distance <= radius) expectedCount++;
+                    assert(search.GetDistance(v) == (all[v].distance <= radius ? all[v].distance : -1));
+                }
+                assert(near.GetLength() == expectedCount);
+                for (int i = 0; i < near.GetLength(); i++) {
+                    assert(near[i].distance == all[near[i].vertex].distance);
+                    assert(i == 0 || near[i - 1].distance <= near[i].distance);
+                }
+            }
+            const auto& nearest = search.Nearest(source, 25);
+            int reachable = 0;
+            int farthest = 0;
+            for (int i = 0; i < nearest.GetLength(); i++) {
+                assert(nearest[i].distance == all[nearest[i].vertex].distance);
+                if (nearest[i].distance > farthest) farthest = nearest[i].distance;
+            }
+            for (int v = 0; v < 1000; v++) {
+                if (all[v].distance != -1) reachable++;
+                // nothing outside the answer is strictly closer than its farthest vertex
+                if (all[v].distance != -1 && search.GetDistance(v) == -1) assert(all[v].distance >= farthest);
+            }
+            assert(nearest.GetLength() == (reachable < 25 ? reachable : 25));
+            assert(nearest[0].vertex == source && nearest[0].distance == 0);
+            DynamicArray<int> path = search.GetPath(nearest[nearest.GetLength() - 1].vertex);
+            assert(path[0] == csr.GetVertex(source));
+        }
+        assert(search.Nearest(-1, 5).GetLength() == 0 && search.WithinRadius(0, -1).GetLength() == 0);
+        cout << "Test: bounded shortest-path queries -> Passed.\n";
+    }
+
+    {
+        // a 30x30 grid whose vertices were inserted in a scrambled order
+        const int side = 30;
+        Graph<int, double> grid;
+        for (int i = 0; i < side * side; i++) grid.InsertVertex((i * 7919) % (side * side));
+        for (int v = 0; v < side * side; v++) {
+            if (v % side + 1 < side) grid.ConnectNodes(v, v + 1, 1.0 + v % 5);
+            if (v + side < side * side) grid.ConnectNodes(v, v + side, 2.0 + v % 3);
+        }
+        CsrGraph<int> csr(grid);
+        auto bandwidth = [](const CsrGraph<int>& g) {
+            int result = 0;
+            for (int u = 0; u < g.GetNodeCount(); u++) {
+                for (int e = g.RowBegin(u); e < g.RowEnd(u); e++) {
+                    int d = g.GetTarget(e) > u ? g.GetTarget(e) - u : u - g.GetTarget(e);
+                    if (d > result) result = d;
+                }
+            }
+            return result;
+        };
+        VertexOrder orders[] = { VertexOrder::Degree, VertexOrder::ReverseCuthillMcKee,
+            VertexOrder::BreadthFirst, VertexOrder::Community };
+        for (VertexOrder order : orders) {
+            DynamicArray<int> newIndex = ComputeVertexOrder(csr, order);
+            CsrGraph<int> permuted = csr.Permute(newIndex);
+            assert(permuted.GetEdgeCount() == csr.GetEdgeCount());
+            for (int u = 0; u < csr.GetNodeCount(); u++) {
+                int nu = newIndex[u];
+                assert(permuted.GetVertex(nu) == csr.GetVertex(u) && permuted.FindNodeIndex(csr.GetVertex(u)) == nu);
+                assert(permuted.GetDegree(nu) == csr.GetDegree(u));
+                for (int e = permuted.RowBegin(nu); e < permuted.RowEnd(nu); e++) {
+                    assert(e == permuted.RowBegin(nu) || permuted.GetTarget(e - 1) < permuted.GetTarget(e));
+                    assert(grid.GetEdgeWeight(permuted.GetVertex(nu), permuted.GetVertex(permuted.GetTarget(e))) == permuted.GetWeight(e));
+                }
+            }
+            if (order == VertexOrder::ReverseCuthillMcKee) assert(bandwidth(permuted) * 4 < bandwidth(csr));
+            if (order == VertexOrder::BreadthFirst) assert(newIndex[0] == 0);
+            if (order == VertexOrder::Degree) {
+                for (int v = 1; v < permuted.GetNodeCount(); v++) assert(permuted.GetDegree(v - 1) >= permuted.GetDegree(v));
+            }
+        }
+
+        Graph<int, double, Directed> dg;
+        dg.GenerateGraph(300, 1200, 1.0, 10.0);
+        Graph<int, double, Directed> original = dg;
+        auto before = MinDistances(dg, dg.GetVertex(0));
+        unsigned long long version = dg.GetVersion();
+        DynamicArray<int> newIndex = ReorderVertices(dg, VertexOrder::ReverseCuthillMcKee);
+        assert(dg.GetVersion() != version);
+        auto after = MinDistances(dg, original.GetVertex(0));
+        for (int i = 0; i < 300; i++) {
+            int key = original.GetVertex(i);
+            assert(dg.GetVertex(newIndex[i]) == key && dg.FindNodeIndex(key) == newIndex[i]);
+            assert(after[newIndex[i]].distance == before[i].distance);
+            auto edges = original.GetAdjacentVertices(key);
+            for (int e = 0; e < edges.GetLength(); e++) {
+                assert(dg.GetEdgeWeight(key, edges[e].GetNode()) == edges[e].GetWeight());
+            }
+            assert(dg.GetIncomingVertices(key).GetLength() == original.GetIncomingVertices(key).GetLength());
+        }
+        DynamicArray<int> notPermutation;
+        for (int i = 0; i < 300; i++) notPermutation.Append(0);
+        bool thrown = false;
+        try { dg.Reorder(notPermutation); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown);
+        cout << "Test: vertex reordering -> Passed.\n";
+    }
+
+    {
+        Graph<int, double, Directed> g;
+        g.GenerateGraph(5000, 30000, 1.0, 40.0);
+        g.InsertVertex(100000);
+        g.ConnectNodes(100000, 0, 3.0);
+        CsrGraph<int> csr(g);
+        CompressedGraph<int> compressed(csr);
+        assert(compressed.GetNodeCount() == csr.GetNodeCount() && compressed.GetEdgeCount() == csr.GetEdgeCount());
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            DynamicArray<int> expected;
+            for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) expected.Append(csr.GetTarget(e));
+            if (expected.GetLength() > 1) std::sort(expected.begin(), expected.end());
+            int i = 0;
+            compressed.ForEachNeighbor(v, [&](int target, double weight) {
+                assert(target == expected[i++]);
+                assert(weight == g.GetEdgeWeight(csr.GetVertex(v), csr.GetVertex(target)));
+            });
+            assert(i == expected.GetLength() && compressed.GetDegree(v) == i);
+        }
+        BfsResult bfsExpected = BreadthFirstSearch(csr, 7);
+        BfsResult bfsActual = BreadthFirstSearch(compressed, 7);
+        SsspResult ssspExpected = DijkstraDistances(csr, 7);
+        SsspResult ssspActual = DijkstraDistances(compressed, 7);
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            assert(bfsExpected.distance[v] == bfsActual.distance[v]);
+            assert(ssspExpected.distance[v] == ssspActual.distance[v]);
+        }
+        assert(compressed.BitsPerEdge() < 32.0 && compressed.MemoryUsage() < csr.MemoryUsage());
+        cout << "Test: compressed adjacency -> Passed.\n";
+    }
+
+    {
+        Graph<int, double> g;
+        g.GenerateGraph(2000, 5000, 1.0, 10.0);
+        g.InsertVertex(5000);
+        g.InsertVertex(5001);
+        g.ConnectNodes(5000, 5001, 2.0);
+        g.SaveToFile("stream_test.tmp");
+        TextEdgeStream<int> text("stream_test.tmp");
+        WriteBinaryEdgeList(text, "stream_test.bin");
+        BinaryEdgeStream<double> binary("stream_test.bin");
+        assert(text.GetNodeCount() == g.GetNodeCount() && binary.GetNodeCount() == g.GetNodeCount());
+
+        DegreeStatistics textDegrees = StreamingDegrees(text);
+        DegreeStatistics binaryDegrees = StreamingDegrees(binary);
+        assert(textDegrees.edgeCount == 5001 && binaryDegrees.edgeCount == 5001);
+        for (int v = 0; v < g.GetNodeCount(); v++) {
+            int degree = g.GetAdjacentVertices(text.GetVertex(v)).GetLength();
+            assert(textDegrees.outDegree[v] + textDegrees.inDegree[v] == degree);
+            assert(binaryDegrees.outDegree[v] == textDegrees.outDegree[v] && binaryDegrees.inDegree[v] == textDegrees.inDegree[v]);
+        }
+
+        ComponentsResult expected = ConnectedComponents(g);
+        ComponentsResult streamed = StreamingComponents(binary);
+        assert(streamed.GetCount() == expected.GetCount());
+        for (int v = 0; v < g.GetNodeCount(); v++) {
+            // text ids follow the saved vertex list, which is the node order of g
+            assert(streamed.sizes[streamed.component[v]] == expected.sizes[expected.component[v]]);
+        }
+
+        int passes = 0;
+        DynamicArray<int> colors = StreamingColoring(text, &passes);
+        for (int v = 0; v < g.GetNodeCount(); v++) {
+            assert(colors[v] >= 0 && colors[v] <= g.GetAdjacentVertices(text.GetVertex(v)).GetLength());
+            auto edges = g.GetAdjacentVertices(text.GetVertex(v));
+            for (int e = 0; e < edges.GetLength(); e++) {
+                assert(colors[g.FindNodeIndex(edges[e].GetNode())] != colors[v]);
+            }
+        }
+        assert(passes < 100);
+
+        // the streams keep their own copy of the file name for later passes
+        char name[32];
+        std::snprintf(name, sizeof(name), "%s", "stream_test.bin");
+        BinaryEdgeStream<double> named(name);
+        std::snprintf(name, sizeof(name), "%s", "missing.bin");
+        assert(StreamingDegrees(named).edgeCount == 5001);
+
+        // a clique of 80 needs more than one 64-color window
+        Graph<int, double> clique;
+        for (int i = 0; i < 80; i++) clique.InsertVertex(i);
+        for (int i = 0; i < 80; i++) {
+            for (int j = i + 1; j < 80; j++) clique.ConnectNodes(i, j, 1.0);
+        }
+        clique.SaveToFile("stream_test.tmp");
+        TextEdgeStream<int> cliqueStream("stream_test.tmp");
+        DynamicArray<int> cliqueColors = StreamingColoring(cliqueStream);
+        HashTable<int, bool> used(200);
+        for (int v = 0; v < 80; v++) {
+            assert(!used.exist(cliqueColors[v]) && cliqueColors[v] < 80);
+            used.insert(cliqueColors[v], true);
+        }
+        std::remove("stream_test.tmp");
+        std::remove("stream_test.bin");
+        cout << "Test: streaming edge-file algorithms -> Passed.\n";
+    }
+
+    {
+        // a directed graph is saved grouped by source, so its file streams straight into the rows
+        Graph<int, double, Directed> g;
+        g.GenerateGraph(3000, 20000, 1.0, 40.0);
+        g.InsertVertex(100000);
+        g.ConnectNodes(100000, 5, 2.5);
+        g.SaveToFile("compressed_test.tmp");
+        CsrGraph<int> csr(g);
+        TextEdgeStream<int> text("compressed_test.tmp");
+        WriteBinaryEdgeList(text, "compressed_test.bin");
+        BinaryEdgeStream<double> binary("compressed_test.bin");
+        CompressedGraph<int> expected(csr);
+        CompressedGraph<int> fromText = CompressedGraph<int>::FromEdgeStream<Directed>(text);
+        CompressedGraph<int> fromBinary = CompressedGraph<int>::FromEdgeStream<Directed>(binary);
+        CompressedGraph<int, QuantizedWeights> quantized(csr);
+        CompressedGraph<int, QuantizedWeights> quantizedText = CompressedGraph<int, QuantizedWeights>::FromEdgeStream<Directed>(text);
+        assert(fromText.GetNodeCount() == expected.GetNodeCount() && fromText.GetEdgeCount() == expected.GetEdgeCount());
+        assert(fromBinary.GetEdgeCount() == expected.GetEdgeCount() && fromText.MemoryUsage() == expected.MemoryUsage());
+        for (int v = 0; v < expected.GetNodeCount(); v++) {
+            assert(fromText.GetVertex(v) == expected.GetVertex(v) && fromBinary.GetVertex(v) == v);
+            DynamicArray<int> targets;
+            DynamicArray<double> weights;
+            expected.ForEachNeighbor(v, [&](int target, double weight) {
+                targets.Append(target);
+                weights.Append(weight);
+            });
+            int i = 0, j = 0, k = 0;
+            fromText.ForEachNeighbor(v, [&](int target, double weight) {
+                assert(target == targets[i] && weight == weights[i]);
+                i++;
+            });
+            fromBinary.ForEachNeighbor(v, [&](int target, double weight) {
+                assert(target == targets[j] && weight == weights[j]);
+                j++;
+            });
+            DynamicArray<double> quantizedWeights;
+            quantized.ForEachNeighbor(v, [&](int, double weight) { quantizedWeights.Append(weight); });
+            quantizedText.ForEachNeighbor(v, [&](int, double weight) { assert(weight == quantizedWeights[k++]); });
+            assert(i == targets.GetLength() && j == targets.GetLength() && k == targets.GetLength());
+        }
+        assert(fromText.FindNodeIndex(100000) == expected.FindNodeIndex(100000));
+        assert(fromText.IsDirected() && expected.IsDirected());
+
+        // an undirected file lists every edge once; both rows get it, a loop only one
+        Graph<int, double> u;
+        u.GenerateGraph(2000, 9000, 1.0, 30.0);
+        u.ConnectNodes(u.GetVertex(3), u.GetVertex(3), 4.0);
+        u.SaveToFile("compressed_test.tmp");
+        CsrGraph<int> undirectedCsr(u);
+        CompressedGraph<int> undirectedExpected(undirectedCsr);
+        TextEdgeStream<int> undirectedText("compressed_test.tmp");
+        // a small pass budget splits the rows into many ranges
+        CompressedGraph<int> undirectedSmall = CompressedGraph<int>::FromEdgeStream<Undirected>(undirectedText, 500);
+        CompressedGraph<int> undirectedWhole = CompressedGraph<int>::FromEdgeStream<Undirected>(undirectedText);
+        assert(!undirectedSmall.IsDirected() && !undirectedExpected.IsDirected());
+        assert(undirectedSmall.GetEdgeCount() == undirectedCsr.GetEdgeCount());
+        assert(undirectedWhole.GetEdgeCount() == undirectedCsr.GetEdgeCount());
+        assert(undirectedSmall.MemoryUsage() == undirectedExpected.MemoryUsage());
+        for (int v = 0; v < undirectedExpected.GetNodeCount(); v++) {
+            DynamicArray<int> targets;
+            DynamicArray<double> weights;
+            undirectedExpected.ForEachNeighbor(v, [&](int target, double weight) {
+                targets.Append(target);
+                weights.Append(weight);
+            });
+            int i = 0, j = 0;
+            undirectedSmall.ForEachNeighbor(v, [&](int target, double weight) {
+                assert(target == targets[i] && weight == weights[i]);
+                i++;
+            });
+            undirectedWhole.ForEachNeighbor(v, [&](int target, double weight) {
+                assert(target == targets[j] && weight == weights[j]);
+                j++;
+            });
+            assert(i == targets.GetLength() && j == targets.GetLength());
+        }
+        SsspResult undirectedSssp = DijkstraDistances(undirectedCsr, 11);
+        SsspResult streamedSssp = DijkstraDistances(undirectedSmall, 11);
+        for (int v = 0; v < undirectedCsr.GetNodeCount(); v++) {
+            assert(undirectedSssp.distance[v] == streamedSssp.distance[v]);
+        }
+
+        // records of a later source before an earlier one cannot be encoded in one pass
+        std::ofstream unsorted("compressed_test.bin", std::ios::binary);
+        int32_t header = 3;
+        int32_t records[2][2] = { { 2, 0 }, { 1, 0 } };
+        double weight = 1.0;
+        unsorted.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int r = 0; r < 2; r++) {
+            unsorted.write(reinterpret_cast<const char*>(records[r]), sizeof(records[r]));
+            unsorted.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+        }
+        unsorted.close();
+        BinaryEdgeStream<double> unsortedStream("compressed_test.bin");
+        bool thrown = false;
+        try { CompressedGraph<int>::FromEdgeStream<Directed>(unsortedStream); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown);
+        std::remove("compressed_test.tmp");
+        std::remove("compressed_test.bin");
+        cout << "Test: compressed adjacency from an edge stream -> Passed.\n";
+    }
+
+    {
+        auto sameGraph = [](const auto& a, const auto& b) {
+            assert(a.GetNodeCount() == b.GetNodeCount());
+            for (int i = 0; i < a.GetNodeCount(); i++) {
+                auto key = a.GetVertex(i);
+                auto edges = a.GetAdjacentVertices(key);
+                assert(b.HasVertex(key) && b.GetAdjacentVertices(key).GetLength() == edges.GetLength());
+                for (int e = 0; e < edges.GetLength(); e++) {
+                    assert(b.GetEdgeWeight(key, edges[e].GetNode()) == edges[e].GetWeight());
+                }
+            }
+        };
+        std::remove("wal_test.snapshot");
+        std::remove("wal_test.log");
+
+        Graph<int, double, Directed> live;
+        {
+            MutationLog<int, double, Directed> log(live, "wal_test", 8);
+            assert(log.Recover() == 0 && live.GetNodeCount() == 0);
+            for (int i = 0; i < 50; i++) log.InsertVertex(i);
+            for (int i = 0; i < 200; i++) log.ConnectNodes(std::rand() % 50, std::rand() % 50, 0.1 * (std::rand() % 100));
+            log.ConnectNodes(10, 11, 4.0);
+            assert(log.GetPendingCount() < 8);
+            log.Checkpoint();
+            assert(log.GetPendingCount() == 0);
+            log.EraseVertex(3);
+            log.DisconnectNodes(10, 11);
+            log.ConnectNodes(10, 11, 1.0 / 3.0);
+            log.SetEdgeWeight(10, 11, 2.0 / 3.0);
+            log.InsertVertex(100);
+            log.ConnectNodes(100, 10, 5.0);
+            log.Commit();
+        }
+
+        Graph<int, double, Directed> recovered;
+        MutationLog<int, double, Directed> log(recovered, "wal_test");
+        assert(log.Recover() == 6);
+        sameGraph(live, recovered);
+        sameGraph(recovered, live);
+
+        // a torn record at the end is dropped and the log stays usable
+        {
+            std::ofstream torn("wal_test.log", std::ios::binary | std::ios::app);
+            torn.write("\x09\x00\x00\x00\x01\x02", 6);
+        }
+        Graph<int, double, Directed> again;
+        MutationLog<int, double, Directed> second(again, "wal_test");
+        assert(second.Recover() == 6);
+        second.EraseVertex(100);
+        second.Commit();
+        Graph<int, double, Directed> third;
+        MutationLog<int, double, Directed> thirdLog(third, "wal_test");
+        assert(thirdLog.Recover() == 7 && !third.HasVertex(100) && third.GetNodeCount() == live.GetNodeCount() - 1);
+
+        Graph<std::string, double> names;
+        {
+            MutationLog<std::string, double> nameLog(names, "wal_test_names");
+            nameLog.Recover();
+            nameLog.InsertVertex("alpha");
+            nameLog.InsertVertex("beta");
+            nameLog.ConnectNodes("alpha", "beta", 2.5);
+        }
+        Graph<std::string, double> namesRecovered;
+        MutationLog<std::string, double> nameLog(namesRecovered, "wal_test_names");
+        nameLog.Recover();
+        sameGraph(names, namesRecovered);
+
+        std::remove("wal_test.snapshot");
+        std::remove("wal_test.log");
+        std::remove("wal_test_names.log");
+        cout << "Test: mutation log -> Passed.\n";
+    }
+
+    {
+        // the graph must still match the CSR taken before
+        auto matches = [](const auto& graph, const auto& csr) {
+            assert(graph.GetNodeCount() == csr.GetNodeCount());
+            for (int v = 0; v < csr.GetNodeCount(); v++) {
+                assert(graph.GetVertex(v) == csr.GetVertex(v) && graph.FindNodeIndex(csr.GetVertex(v)) == v);
+                auto edges = graph.GetAdjacentVertices(csr.GetVertex(v));
+                assert(edges.GetLength() == csr.GetDegree(v));
+                for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                    assert(graph.GetEdgeWeight(csr.GetVertex(v), csr.GetVertex(csr.GetTarget(e))) == csr.GetWeight(e));
+                }
+                if (graph.IsDirected()) {
+                    assert(graph.GetIncomingVertices(csr.GetVertex(v)).GetLength() == csr.GetInDegree(v));
+                }
+            }
+        };
+
+        Graph<int, double, Directed> g;
+        g.GenerateGraph(3000, 12000, 1.0, 10.0);
+        for (int i = 1; i <= 100; i++) g.ConnectNodes(0, i, 1.0);
+        CsrGraph<int> before(g);
+
+        Graph<int, double, Directed> snapshot = g.Snapshot();
+        matches(snapshot, before);
+        snapshot.EraseVertex(5);
+        snapshot.DisconnectNodes(0, 50);
+        snapshot.ConnectNodes(7, 8, 0.5);
+        snapshot.InsertVertex(-1);
+        snapshot.ConnectNodes(-1, 0, 2.0);
+        snapshot.SetEdgeWeight(0, 60, 9.0);
+        DynamicArray<int> batch;
+        for (int i = 2000; i < 2100; i++) batch.Append(i);
+        snapshot.EraseVertices(batch);
+        matches(g, before);
+        CsrGraph<int> snapshotBefore(snapshot);
+
+        // the original changes without touching the snapshot
+        g.EraseVertex(0);
+        g.ConnectNodes(5, 6, 3.0);
+        DynamicArray<int> newIndex;
+        for (int i = 0; i < g.GetNodeCount(); i++) newIndex.Append(g.GetNodeCount() - 1 - i);
+        g.Reorder(newIndex);
+        matches(snapshot, snapshotBefore);
+        assert(!snapshot.HasVertex(5) && snapshot.HasVertex(0) && snapshot.GetEdgeWeight(0, 60) == 9.0);
+        assert(g.HasVertex(5) && !g.HasVertex(0) && g.GetEdgeWeight(5, 6) == 3.0);
+
+        Graph<std::string, double> names;
+        names.InsertVertex("a");
+        names.InsertVertex("b");
+        names.ConnectNodes("a", "b", 1.0);
+        Graph<std::string, double> copy;
+        copy = names;
+        copy.ClearGraph();
+        copy.InsertVertex("c");
+        assert(names.GetNodeCount() == 2 && names.HasEdge("b", "a") && !names.HasVertex("c"));
+        cout << "Test: copy-on-write snapshots -> Passed.\n";
+    }
+
+    {
+        // a batch must end in the same graph as applying its operations one by one
+        auto check = [](auto graph) {
+            using Op = EdgeOperation<int, double>;
+            std::srand(7);
+            graph.GenerateGraph(200, 600, 1.0, 10.0);
+            for (int i = 1; i <= 60; i++) graph.ConnectNodes(0, i, 1.0);
+            DynamicArray<Op> ops;
+            for (int i = 0; i < 3000; i++) {
+                // small ranges so that the same edges are touched many times
+                int a = std::rand() % 70, b = std::rand() % 70;
+                if (std::rand() % 2) ops.Append(Op::Connect(a, b, 1.0 + std::rand() % 9));
+                else ops.Append(Op::Disconnect(a, b));
+            }
+            auto expected = graph;
+            for (int i = 0; i < ops.GetLength(); i++) {
+                if (ops[i].type == EdgeOperationType::Connect) expected.ConnectNodes(ops[i].from, ops[i].to, ops[i].weight);
+                else expected.DisconnectNodes(ops[i].from, ops[i].to);
+            }
+            unsigned long long version = graph.GetVersion();
+            graph.ApplyBatch(ops);
+            assert(graph.GetVersion() == version + 1);
+            for (int u = 0; u < graph.GetNodeCount(); u++) {
+                assert(graph.GetAdjacentVertices(u).GetLength() == expected.GetAdjacentVertices(u).GetLength());
+                assert(graph.GetIncomingVertices(u).GetLength() == expected.GetIncomingVertices(u).GetLength());
+                for (int v = 0; v < graph.GetNodeCount(); v++) {
+                    assert(graph.HasEdge(u, v) == expected.HasEdge(u, v));
+                    if (graph.HasEdge(u, v)) assert(graph.GetEdgeWeight(u, v) == expected.GetEdgeWeight(u, v));
+                }
+            }
+
+            // an unknown vertex rejects the whole batch
+            auto before = graph;
+            ops.Append(Op::Connect(1, 500, 1.0));
+            bool thrown = false;
+            try {
+                graph.ApplyBatch(ops);
+            }
+            catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            assert(thrown && graph.GetVersion() == version + 1);
+            for (int u = 0; u < graph.GetNodeCount(); u++) {
+                assert(graph.GetAdjacentVertices(u).GetLength() == before.GetAdjacentVertices(u).GetLength());
+            }
+        };
+        SetThreadCount(4);
+        check(Graph<int, double>());
+        check(Graph<int, double, Directed>());
+        SetThreadCount(0);
+        cout << "Test: batch mutations -> Passed.\n";
+    }
+
+    {
+        // views must agree with a graph built from the visible vertices and edges
+        std::srand(11);
+        Graph<int, int> g;
+        g.GenerateGraph(300, 1500, 1, 20);
+        CsrGraph<int, ExactWeights<int>> csr(g);
+        DynamicArray<bool> mask;
+        for (int v = 0; v < g.GetNodeCount(); v++) mask.Append(v % 3 != 1);
+        auto light = [](int, int, int w) { return w <= 12; };
+
+        Graph<int, int> built;
+        for (int v = 0; v < g.GetNodeCount(); v++) {
+            if (mask[v]) built.InsertVertex(g.GetVertex(v));
+        }
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                if (mask[v] && mask[csr.GetTarget(e)] && csr.GetWeight(e) <= 12)
+                    built.ConnectNodes(csr.GetVertex(v), csr.GetVertex(csr.GetTarget(e)), csr.GetWeight(e));
+            }
+        }
+
+        auto view = FilterEdges(MaskVertices(csr, mask), light);
+        auto swapped = MaskVertices(FilterEdges(g, light), mask);
+        int start = g.GetVertex(0);
+        auto viewPaths = MinDistances(view, start);
+        auto swappedPaths = MinDistances(swapped, start);
+        auto builtPaths = MinDistances(built, start);
+        for (int v = 0; v < g.GetNodeCount(); v++) {
+            int b = built.FindNodeIndex(g.GetVertex(v));
+            int expected = b == -1 ? -1 : builtPaths[b].distance;
+            assert(viewPaths[v].distance == expected && swappedPaths[v].distance == expected);
+            if (expected > 0) assert(viewPaths[v].path[viewPaths[v].path.GetLength() - 1] == g.GetVertex(v));
+        }
+        assert(MinDistances(view, g.GetVertex(1))[0].distance == -1);
+
+        DynamicArray<int> colors = GraphColoring(view);
+        for (int v = 0; v < csr.GetNodeCount(); v++) {
+            assert((colors[v] == -1) == !mask[v]);
+            view.ForEachNeighbor(v, [&](int w, int) { assert(colors[v] != colors[w]); });
+        }
+        BfsResult bfs = BreadthFirstSearch(ViewOf(csr), 0);
+        BfsResult full = BreadthFirstSearch(csr, 0);
+        for (int v = 0; v < csr.GetNodeCount(); v++) assert(bfs.distance[v] == full.distance[v]);
+
+        // directed: a vertex sees its visible incoming edges too
+        Graph<int, int, Directed> d;
+        for (int v = 0; v < 4; v++) d.InsertVertex(v);
+        d.ConnectNodes(0, 1, 1);
+        d.ConnectNodes(2, 1, 5);
+        d.ConnectNodes(1, 3, 1);
+        auto cheap = FilterEdges(d, [](int, int, int w) { return w < 5; });
+        int incoming = 0;
+        cheap.ForEachInNeighbor(1, [&](int source, int) { assert(source == 0); incoming++; });
+        assert(incoming == 1 && MinDistances(cheap, 0)[3].distance == 2);
+        DynamicArray<int> directedColors = GraphColoring(cheap);
+        assert(directedColors[0] != directedColors[1] && directedColors[1] != directedColors[3]);
+        cout << "Test: filtered graph views -> Passed.\n";
+    }
+
+    {
+        DynamicArray<int> values;
+        for (int i = 0; i < 100; i++) values.Append((i * 37) % 100);
+        std::sort(values.begin(), values.end());
+        int expected = 0;
+        for (int v : values) assert(v == expected++);
+        assert(values.end() - values.begin() == 100 && values.data() == &values[0]);
+
+        const DynamicArray<int>& constant = values;
+        ArrayView<const int> all(constant);
+        ArrayView<const int> middle = all.Subview(10, 5);
+        assert(middle.GetLength() == 5 && middle[0] == 10 && *(middle.end() - 1) == 14);
+        ArrayView<int> writable(values);
+        for (int& v : writable.Subview(0, 3)) v = -1;
+        assert(values[0] == -1 && values[2] == -1 && values[3] == 3);
+        bool thrown = false;
+        try {
+            all.Subview(95, 10);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown && ArrayView<int>().IsEmpty());
+#if DYNAMIC_ARRAY_BOUNDS_CHECK
+        thrown = false;
+        try {
+            values[100] = 0;
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+#endif
+        cout << "Test: array iterators and views -> Passed.\n";
+    }
+
+    {
+        DefaultHash<Pair<int, int>> pairHash;
+        for (int a = 0; a < 50; a++) {
+            for (int b = a + 1; b < 50; b++) assert(pairHash(Pair<int, int>(a, b)) != pairHash(Pair<int, int>(b, a)));
+        }
+        // every length, including the tails around 4, 8, 16 and 48 bytes
+        std::string text;
+        HashTable<size_t, int> seen(300);
+        for (int length = 0; length < 200; length++) {
+            size_t hash = DefaultHash<std::string>()(text);
+            assert(hash == HashBytes(text.data(), text.size()) && !seen.exist(hash));
+            seen.insert(hash, length);
+            text += static_cast<char>('a' + length % 26);
+        }
+        assert(DefaultHash<double>()(0.0) == DefaultHash<double>()(-0.0));
+
+        // seeded hashers differ; tables made before a seed change keep working
+        HashTable<std::string, int> before;
+        before.insert("x", 1);
+        SetHashSeed(12345);
+        assert(DefaultHash<int>()(7) != 7 && DefaultHash<std::string>()("x") != HashBytes("x", 1));
+        HashTable<int, int> seeded;
+        for (int i = 0; i < 1000; i++) seeded.insert(i * 1024, i);
+        SetHashSeed(0);
+        before.insert("y", 2);
+        assert(before.get("x") == 1 && before.get("y") == 2 && seeded.get(5 * 1024) == 5 && seeded.size() == 1000);
+
+        // strided keys still spread over the low bits after mixing
+        DynamicArray<bool> used;
+        for (int i = 0; i < 1024; i++) used.Append(false);
+        int distinct = 0;
+        for (int i = 0; i < 512; i++) {
+            size_t slot = MixedHash<int>()(i * 1024) & 1023;
+            if (!used[static_cast<int>(slot)]) distinct++;
+            used[static_cast<int>(slot)] = true;
+        }
+        assert(distinct > 350);
+        cout << "Test: hashing -> Passed.\n";
+    }
+
+    {
+        // brute force over all vertex triples of the underlying undirected graph
+        auto check = [](const auto& graph) {
+            CsrGraph<int> csr(graph);
+            int n = csr.GetNodeCount();
+            DynamicArray<bool> adjacent;
+            for (int i = 0; i < n * n; i++) adjacent.Append(false);
+            for (int v = 0; v < n; v++) {
+                for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                    int w = csr.GetTarget(e);
+                    if (w != v) adjacent[v * n + w] = adjacent[w * n + v] = true;
+                }
+            }
+            TriangleStatistics stats = CountTriangles(csr);
+            long long total = 0;
+            for (int v = 0; v < n; v++) {
+                long long through = 0, degree = 0;
+                for (int u = 0; u < n; u++) {
+                    if (!adjacent[v * n + u]) continue;
+                    degree++;
+                    for (int w = u + 1; w < n; w++) {
+                        if (adjacent[v * n + w] && adjacent[u * n + w]) through++;
+                    }
+                }
+                total += through;
+                assert(stats.triangles[v] == through);
+                double expected = degree < 2 ? 0.0 : 2.0 * through / (degree * (degree - 1));
+                assert(std::fabs(stats.clustering[v] - expected) < 1e-12);
+            }
+            assert(stats.totalTriangles * 3 == total);
+            return stats;
+        };
+        SetThreadCount(4);
+        std::srand(5);
+        Graph<int, double> random;
+        random.GenerateGraph(120, 1500, 1.0, 2.0);
+        // a hub joined to everything makes the galloping path run
+        for (int v = 1; v < 120; v++) random.ConnectNodes(0, v, 1.0);
+        check(random);
+        Graph<int, double, Directed> directed;
+        directed.GenerateGraph(80, 900, 1.0, 2.0);
+        directed.ConnectNodes(3, 3, 1.0);
+        check(directed);
+
+        Graph<int, double> clique;
+        for (int v = 0; v < 5; v++) clique.InsertVertex(v);
+        for (int v = 0; v < 5; v++) {
+            for (int w = v + 1; w < 5; w++) clique.ConnectNodes(v, w, 1.0);
+        }
+        TriangleStatistics k5 = check(clique);
+        assert(k5.totalTriangles == 10 && k5.triangles[2] == 6 && k5.averageClustering == 1.0);
+        SetThreadCount(0);
+
+        // the kernels agree on lists with and without common runs
+        DynamicArray<int> a, b;
+        for (int i = 0; i < 1000; i++) {
+            a.Append(i * 3);
+            if (i % 7 != 0) b.Append(i * 2);
+        }
+        long long merged = 0, blocks = 0, galloping = 0;
+        TriangleDetail::IntersectScalar(a.data(), a.GetLength(), b.data(), b.GetLength(), [&](int x) { merged += x; });
+        TriangleDetail::IntersectBlocks(a.data(), a.GetLength(), b.data(), b.GetLength(), [&](int x) { blocks += x; });
+        TriangleDetail::IntersectGalloping(a.data(), 40, b.data(), b.GetLength(), [&](int x) { galloping += x; });
+        long long prefix = 0;
+        TriangleDetail::IntersectScalar(a.data(), 40, b.data(), b.GetLength(), [&](int x) { prefix += x; });
+        assert(merged == blocks && merged > 0 && galloping == prefix && prefix > 0);
+        cout << "Test: triangle counting -> Passed.\n";
+    }
+
+    {
+        // brute force: all-pairs distances and path counts, then sigma_st(v) / sigma_st for every pair
+        auto check = [](const auto& graph) {
+            CsrGraph<int> csr(graph);
+            int n = csr.GetNodeCount();
+            DynamicArray<double> dist, count;
+            for (int i = 0; i < n * n; i++) {
+                dist.Append(i % (n + 1) == 0 ? 0.0 : 1e18);
+                count.Append(i % (n + 1) == 0 ? 1.0 : 0.0);
+            }
+            for (int v = 0; v < n; v++) {
+                for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                    int w = csr.GetTarget(e);
+                    if (w != v && csr.GetWeight(e) < dist[v * n + w]) dist[v * n + w] = csr.GetWeight(e);
+                }
+            }
+            for (int m = 0; m < n; m++) {
+                for (int i = 0; i < n; i++) {
+                    for (int j = 0; j < n; j++) {
+                        if (dist[i * n + m] + dist[m * n + j] < dist[i * n + j]) dist[i * n + j] = dist[i * n + m] + dist[m * n + j];
+                    }
+                }
+            }
+            // paths from s in order of distance: sigma(s, t) sums sigma(s, u) over the last edges (u, t)
+            for (int s = 0; s < n; s++) {
+                DynamicArray<int> order;
+                for (int t = 0; t < n; t++) order.Append(t);
+                std::sort(order.begin(), order.end(), [&](int x, int y) { return dist[s * n + x] < dist[s * n + y]; });
+                for (int i = 1; i < n; i++) {
+                    int t = order[i];
+                    for (int u = 0; u < n; u++) {
+                        for (int e = csr.RowBegin(u); e < csr.RowEnd(u); e++) {
+                            if (csr.GetTarget(e) == t && u != t && dist[s * n + u] + csr.GetWeight(e) == dist[s * n + t]) count[s * n + t] += count[s * n + u];
+                        }
+                    }
+                }
+            }
+            DynamicArray<double> actual = BetweennessCentrality(csr);
+            for (int v = 0; v < n; v++) {
+                double expected = 0.0;
+                for (int s = 0; s < n; s++) {
+                    for (int t = 0; t < n; t++) {
+                        if (s == v || t == v || s == t || count[s * n + t] == 0.0) continue;
+                        if (dist[s * n + v] + dist[v * n + t] == dist[s * n + t]) expected += count[s * n + v] * count[v * n + t] / count[s * n + t];
+                    }
+                }
+                if (!csr.IsDirected()) expected /= 2.0;
+                assert(std::fabs(actual[v] - expected) < 1e-6 * (1.0 + expected));
+            }
+        };
+        SetThreadCount(4);
+        std::srand(11);
+        Graph<int, int> unit;
+        unit.GenerateGraph(60, 150, 1, 1);
+        check(unit);
+        Graph<int, int, Directed> weighted;
+        for (int v = 0; v < 50; v++) weighted.InsertVertex(v);
+        for (int i = 0; i < 200; i++) {
+            int a = std::rand() % 50, b = std::rand() % 50;
+            if (a != b && !weighted.HasEdge(a, b)) weighted.ConnectNodes(a, b, 1 + std::rand() % 3);
+        }
+        check(weighted);
+
+        // on a path the middle vertex separates 2 * 2 pairs
+        Graph<int, double> path;
+        for (int v = 0; v < 5; v++) path.InsertVertex(v);
+        for (int v = 0; v < 4; v++) path.ConnectNodes(v, v + 1, 2.5);
+        DynamicArray<double> onPath = BetweennessCentrality(path);
+        assert(onPath[0] == 0.0 && onPath[1] == 3.0 && onPath[2] == 4.0);
+
+        Graph<int, double> negative;
+        negative.InsertVertex(0);
+        negative.InsertVertex(1);
+        negative.InsertVertex(2);
+        negative.ConnectNodes(0, 1, 1.0);
+        negative.ConnectNodes(1, 2, -1.0);
+        bool thrown = false;
+        try {
+            BetweennessCentrality(negative);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // sampling stays within the bound, is reproducible and is exact once k reaches n
+        Graph<int, int> large;
+        large.GenerateGraph(800, 2400, 1, 1);
+        CsrGraph<int> csr(large);
+        int k = BetweennessSampleCount(800, 0.1, 0.1);
+        assert(k > 0 && k < 800);
+        DynamicArray<double> exact = BetweennessCentrality(csr);
+        DynamicArray<double> estimate = ApproximateBetweenness(csr, 0.1, 0.1, 3);
+        DynamicArray<double> again = ApproximateBetweenness(csr, 0.1, 0.1, 3);
+        for (int v = 0; v < 800; v++) {
+            assert(std::fabs(estimate[v] - exact[v]) <= 0.1 * 800 * 798 / 2);
+            // same sources; the per-worker sums may be grouped differently
+            assert(std::fabs(estimate[v] - again[v]) <= 1e-9 * (1.0 + exact[v]));
+        }
+        DynamicArray<double> full = ApproximateBetweenness(unit, 0.01);
+        DynamicArray<double> unitExact = BetweennessCentrality(unit);
+        for (int v = 0; v < 60; v++) assert(std::fabs(full[v] - unitExact[v]) <= 1e-9 * (1.0 + unitExact[v]));
+        SetThreadCount(0);
+        cout << "Test: betweenness centrality -> Passed.\n";
+    }
+
+    {
+        // dense power iteration of the same chain as the reference
+        auto reference = [](const CsrGraph<int>& csr, const DynamicArray<double>& teleport, double damping) {
+            int n = csr.GetNodeCount();
+            DynamicArray<double> rank, out;
+            for (int v = 0; v < n; v++) {
+                rank.Append(teleport[v]);
+                double sum = 0.0;
+                for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) sum += csr.GetWeight(e);
+                out.Append(sum);
+            }
+            for (int iteration = 0; iteration < 500; iteration++) {
+                DynamicArray<double> next;
+                double dangling = 0.0;
+                for (int v = 0; v < n; v++) {
+                    next.Append(0.0);
+                    if (out[v] == 0.0) dangling += rank[v];
+                }
+                for (int u = 0; u < n; u++) {
+                    for (int e = csr.RowBegin(u); e < csr.RowEnd(u); e++) {
+                        if (out[u] > 0.0) next[csr.GetTarget(e)] += rank[u] * csr.GetWeight(e) / out[u];
+                    }
+                }
+                for (int v = 0; v < n; v++) {
+                    rank[v] = damping * (next[v] + dangling * teleport[v]) + (1.0 - damping) * teleport[v];
+                }
+            }
+            return rank;
+        };
+        SetThreadCount(4);
+        std::srand(13);
+        Graph<int, double, Directed> directed;
+        directed.GenerateGraph(700, 3000, 1.0, 5.0);
+        // a vertex without out-edges
+        directed.InsertVertex(700);
+        directed.ConnectNodes(3, 700, 2.0);
+        CsrGraph<int> csr(directed);
+        DynamicArray<double> uniform;
+        for (int v = 0; v < 701; v++) uniform.Append(1.0 / 701);
+        DynamicArray<double> expected = reference(csr, uniform, 0.85);
+        PageRankResult pull = PageRank(csr);
+        PageRankResult push = PageRank(csr, 0.85, 1e-10, 100, PropagationMode::Push);
+        assert(pull.converged && push.converged && pull.residual < 1e-10);
+        double sum = 0.0;
+        for (int v = 0; v < 701; v++) {
+            assert(std::fabs(pull.rank[v] - expected[v]) < 1e-9);
+            assert(std::fabs(push.rank[v] - expected[v]) < 1e-9);
+            sum += pull.rank[v];
+        }
+        assert(std::fabs(sum - 1.0) < 1e-9);
+        PageRankResult capped = PageRank(directed, 0.85, 1e-10, 3);
+        assert(!capped.converged && capped.iterations == 3);
+
+        // all rank restarts at the seed; vertices that cannot be reached from it get none
+        DynamicArray<double> seed;
+        for (int v = 0; v < 701; v++) seed.Append(v == 5 ? 2.0 : 0.0);
+        DynamicArray<double> toSeed;
+        for (int v = 0; v < 701; v++) toSeed.Append(v == 5 ? 1.0 : 0.0);
+        DynamicArray<double> personalizedExpected = reference(csr, toSeed, 0.85);
+        PageRankResult personalized = PersonalizedPageRank(csr, seed, 0.85, 1e-10, 100, PropagationMode::Push);
+        BfsResult reach = BreadthFirstSearch(csr, 5);
+        for (int v = 0; v < 701; v++) {
+            assert(std::fabs(personalized.rank[v] - personalizedExpected[v]) < 1e-9);
+            if (reach.distance[v] == -1) assert(personalized.rank[v] == 0.0);
+        }
+
+        // every vertex of a cycle is alike
+        Graph<int, double> cycle;
+        for (int v = 0; v < 10; v++) cycle.InsertVertex(v);
+        for (int v = 0; v < 10; v++) cycle.ConnectNodes(v, (v + 1) % 10, 3.0);
+        PageRankResult even = PageRank(cycle);
+        for (int v = 0; v < 10; v++) assert(std::fabs(even.rank[v] - 0.1) < 1e-12);
+
+        // row ranges: balanced entries, empty rows split too, and a heavy row stays whole
+        DynamicArray<int> offsets;
+        for (int row = 0; row <= 100; row++) offsets.Append(row < 50 ? 0 : (row - 50) * 10);
+        DynamicArray<int> ranges = BalancedRowRanges(offsets, 4);
+        assert(ranges.GetLength() == 5 && ranges[0] == 0 && ranges[4] == 100);
+        for (int p = 0; p < 4; p++) {
+            long long weight = offsets[ranges[p + 1]] - offsets[ranges[p]] + ranges[p + 1] - ranges[p];
+            assert(ranges[p] <= ranges[p + 1] && weight >= 120 && weight <= 160);
+        }
+        SetThreadCount(0);
+        cout << "Test: PageRank and sparse propagation kernels -> Passed.\n";
+    }
+
+    {
+        SetThreadCount(4);
+        // every index once, workers in range, on skewed work that needs stealing
+        DynamicArray<int> visits;
+        for (int i = 0; i < 100000; i++) visits.Append(0);
+        std::atomic<long long> spent(0);
+        std::atomic<bool> workerInRange(true);
+        ParallelForBlocks(0, 100000, [&](int blockBegin, int blockEnd, int worker) {
+            if (worker < 0 || worker >= 4) workerInRange = false;
+            long long local = 0;
+            for (int i = blockBegin; i < blockEnd; i++) {
+                visits[i]++;
+                for (int k = 0; k < (i < 1000 ? 200 : 1); k++) local += k ^ i;
+            }
+            spent += local;
+        }, 16);
+        for (int i = 0; i < 100000; i++) assert(visits[i] == 1);
+        assert(workerInRange && spent > 0);
+
+        long long sum = ParallelReduce(0, 100000, 0LL, [](int i) { return static_cast<long long>(i); },
+            [](long long a, long long b) { return a + b; });
+        assert(sum == 100000LL * 99999 / 2);
+        int largest = ParallelReduce(0, 5000, -1, [](int i) { return (i * 7919) % 5000; },
+            [](int a, int b) { return a > b ? a : b; }, 64);
+        assert(largest == 4999);
+
+        // a loop inside a loop body runs serially on the calling worker
+        std::atomic<int> inner(0);
+        ParallelFor(0, 64, [&](int) {
+            ParallelFor(0, 1000, [&](int) { inner++; }, 10);
+        }, 1);
+        assert(inner == 64000);
+
+        // the first exception reaches the caller after the loop has finished
+        bool thrown = false;
+        try {
+            ParallelFor(0, 10000, [](int i) {
+                if (i == 7777) throw std::runtime_error("body failed");
+            }, 100);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // the threads are started once: repeated loops run on the same ones
+        std::mutex idsLock;
+        DynamicArray<std::thread::id> ids;
+        for (int round = 0; round < 50; round++) {
+            ParallelFor(0, 4096, [&](int) {
+                std::thread::id id = std::this_thread::get_id();
+                std::lock_guard<std::mutex> guard(idsLock);
+                bool known = false;
+                for (int i = 0; i < ids.GetLength(); i++) known = known || ids[i] == id;
+                if (!known) ids.Append(id);
+            }, 1);
+        }
+        assert(ids.GetLength() <= 4);
+        // every loop runs on GetThreadCount() workers, so buffers sized by it before the loop fit
+        SetThreadCount(3);
+        std::atomic<bool> belowThree(true);
+        ParallelForBlocks(0, 20000, [&](int, int, int worker) {
+            if (worker >= 3) belowThree = false;
+        }, 16);
+        assert(belowThree && GetThreadPool().GetWorkerCount() == 3);
+        SetThreadCount(2);
+        assert(ParallelReduce(0, 3000, 0, [](int) { return 1; }, [](int a, int b) { return a + b; }) == 3000);
+        assert(GetThreadPool().GetWorkerCount() == 2);
+        SetThreadCount(0);
+        cout << "Test: work-stealing thread pool -> Passed.\n";
+    }
+
+    {
+        // adjacent vertices differ, at most max degree + 1 colors, and the same colors on any thread count
+        auto checkColoring = [](const auto& csr) {
+            SetThreadCount(4);
+            DynamicArray<int> colors = ParallelGraphColoring(csr);
+            SetThreadCount(1);
+            DynamicArray<int> serial = ParallelGraphColoring(csr);
+            SetThreadCount(0);
+            assert(colors.GetLength() == csr.GetNodeCount());
+            for (int v = 0; v < csr.GetNodeCount(); v++) {
+                assert(colors[v] == serial[v]);
+                int degree = csr.RowEnd(v) - csr.RowBegin(v);
+                if (csr.IsDirected()) degree += csr.InRowEnd(v) - csr.InRowBegin(v);
+                assert(colors[v] >= 0 && colors[v] <= degree);
+                for (int e = csr.RowBegin(v); e < csr.RowEnd(v); e++) {
+                    assert(csr.GetTarget(e) == v || colors[csr.GetTarget(e)] != colors[v]);
+                }
+            }
+        };
+        Graph<int, double> g;
+        g.GenerateGraph(3000, 20000, 1.0, 2.0);
+        checkColoring(CsrGraph<int>(g));
+        Graph<int, double, Directed> dg;
+        dg.GenerateGraph(2000, 15000, 1.0, 2.0);
+        checkColoring(CsrGraph<int>(dg));
+        assert(ParallelGraphColoring(Graph<int, double>()).GetLength() == 0);
+        cout << "Test: parallel Jones-Plassmann coloring -> Passed.\n";
+    }
+
     cout << "All tests Passed.\n\n";
 }
\ No newline at end of file
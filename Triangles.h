@@ -0,0 +1,250 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Parallel.h"
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Triangle counts and local clustering coefficients of the underlying undirected graph
+// (edge directions, self-loops and parallel edges are ignored).
+struct TriangleStatistics {
+    // triangles through every vertex
+    DynamicArray<long long> triangles;
+    // triangles[v] / (d(v) * (d(v) - 1) / 2) for d(v) distinct neighbors, 0 below two neighbors
+    DynamicArray<double> clustering;
+    long long totalTriangles = 0;
+    double averageClustering = 0.0;
+};
+
+namespace TriangleDetail {
+
+    // Row v spans [offsets[v], offsets[v + 1]) of targets, sorted by id
+    struct SortedAdjacency {
+        DynamicArray<int> offsets;
+        DynamicArray<int> targets;
+    };
+
+    // Lists longer than this many times the other one are searched instead of merged
+    constexpr int GallopingRatio = 32;
+
+    // Merge intersection of two sorted duplicate-free lists; calls visit(x) for every common x
+    template <typename Visit>
+    void IntersectScalar(const int* a, int na, const int* b, int nb, Visit visit)
+    {
+        int i = 0, j = 0;
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) i++;
+            else if (b[j] < a[i]) j++;
+            else {
+                visit(a[i]);
+                i++;
+                j++;
+            }
+        }
+    }
+
+    // Block merge: every block of 4 of a is compared with every rotation of a block of 4 of b
+    // in SIMD registers, and the block with the smaller last element moves on
+    template <typename Visit>
+    void IntersectBlocks(const int* a, int na, const int* b, int nb, Visit visit)
+    {
+        int i = 0, j = 0;
+#if defined(__SSE2__)
+        while (i + 4 <= na && j + 4 <= nb) {
+            __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i equal = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, blockB),
+                    _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))),
+                    _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3)))));
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+            while (mask != 0) {
+                visit(a[i + __builtin_ctz(mask)]);
+                mask &= mask - 1;
+            }
+            // branch-free advance, the comparison is unpredictable
+            int lastA = a[i + 3], lastB = b[j + 3];
+            i += (lastA <= lastB) << 2;
+            j += (lastB <= lastA) << 2;
+        }
+#endif
+        IntersectScalar(a + i, na - i, b + j, nb - j, visit);
+    }
+
+    // Every element of the short list is looked up in the long one by exponential then binary search
+    template <typename Visit>
+    void IntersectGalloping(const int* small, int ns, const int* large, int nl, Visit visit)
+    {
+        int low = 0;
+        for (int i = 0; i < ns && low < nl; i++) {
+            int x = small[i];
+            // large[low + bound / 2] < x, and large[low + bound] >= x unless it is past the end
+            int bound = 1;
+            while (low + bound < nl && large[low + bound] < x) {
+                bound *= 2;
+            }
+            int high = low + bound + 1 < nl ? low + bound + 1 : nl;
+            low = static_cast<int>(std::lower_bound(large + low, large + high, x) - large);
+            if (low < nl && large[low] == x) {
+                visit(x);
+                low++;
+            }
+        }
+    }
+
+    template <typename Visit>
+    void Intersect(const int* a, int na, const int* b, int nb, Visit visit)
+    {
+        if (na * static_cast<long long>(GallopingRatio) < nb) IntersectGalloping(a, na, b, nb, visit);
+        else if (nb * static_cast<long long>(GallopingRatio) < na) IntersectGalloping(b, nb, a, na, visit);
+        else IntersectBlocks(a, na, b, nb, visit);
+    }
+
+    inline void PrefixSums(DynamicArray<int>& offsets, const DynamicArray<int>& lengths)
+    {
+        offsets = DynamicArray<int>(lengths.GetLength() + 1);
+        offsets.Append(0);
+        for (int v = 0; v < lengths.GetLength(); v++) {
+            offsets.Append(offsets[v] + lengths[v]);
+        }
+    }
+
+    // Distinct neighbors of every vertex in both directions, without the vertex itself
+    template <typename TKey, typename WeightPolicy>
+    SortedAdjacency Symmetrize(const CsrGraph<TKey, WeightPolicy>& graph)
+    {
+        int numNodes = graph.GetNodeCount();
+        DynamicArray<int> bounds(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            bounds.Append(graph.GetDegree(v) + (graph.IsDirected() ? graph.GetInDegree(v) : 0));
+        }
+        DynamicArray<int> slots;
+        PrefixSums(slots, bounds);
+        DynamicArray<int> scratch(slots[numNodes]);
+        for (int i = 0; i < slots[numNodes]; i++) {
+            scratch.Append(0);
+        }
+        DynamicArray<int> lengths(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            lengths.Append(0);
+        }
+
+        ParallelFor(0, numNodes, [&](int v) {
+            int* row = scratch.data() + slots[v];
+            int length = 0;
+            graph.ForEachNeighbor(v, [&](int w, typename WeightPolicy::ValueType) { row[length++] = w; });
+            if (graph.IsDirected()) {
+                graph.ForEachInNeighbor(v, [&](int w, typename WeightPolicy::ValueType) { row[length++] = w; });
+            }
+            std::sort(row, row + length);
+            int kept = 0;
+            for (int i = 0; i < length; i++) {
+                if (row[i] != v && (kept == 0 || row[kept - 1] != row[i])) row[kept++] = row[i];
+            }
+            lengths[v] = kept;
+        });
+
+        SortedAdjacency result;
+        PrefixSums(result.offsets, lengths);
+        result.targets = DynamicArray<int>(result.offsets[numNodes]);
+        for (int v = 0; v < numNodes; v++) {
+            for (int i = 0; i < lengths[v]; i++) {
+                result.targets.Append(scratch[slots[v] + i]);
+            }
+        }
+        return result;
+    }
+
+    // Keeps the edges towards higher-ranked vertices, ranked by degree and then id, so that every
+    // triangle is found once, from its lowest-ranked vertex; hubs keep short lists
+    inline SortedAdjacency Orient(const SortedAdjacency& graph)
+    {
+        int numNodes = graph.offsets.GetLength() - 1;
+        auto degree = [&graph](int v) { return graph.offsets[v + 1] - graph.offsets[v]; };
+        auto higher = [&degree](int w, int v) {
+            return degree(w) > degree(v) || (degree(w) == degree(v) && w > v);
+        };
+        DynamicArray<int> lengths(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            int length = 0;
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+                if (higher(graph.targets[e], v)) length++;
+            }
+            lengths.Append(length);
+        }
+        SortedAdjacency result;
+        PrefixSums(result.offsets, lengths);
+        result.targets = DynamicArray<int>(result.offsets[numNodes]);
+        for (int v = 0; v < numNodes; v++) {
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+                if (higher(graph.targets[e], v)) result.targets.Append(graph.targets[e]);
+            }
+        }
+        return result;
+    }
+
+}
+
+// Every triangle {v, u, w} is found once: from v, for each higher-ranked neighbor u, as a common
+// higher-ranked neighbor w of both. Vertices are processed in parallel with per-worker counts.
+template <typename TKey, typename WeightPolicy>
+TriangleStatistics CountTriangles(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    int numNodes = graph.GetNodeCount();
+    TriangleDetail::SortedAdjacency full = TriangleDetail::Symmetrize(graph);
+    TriangleDetail::SortedAdjacency oriented = TriangleDetail::Orient(full);
+
+    int threads = GetThreadCount();
+    DynamicArray<DynamicArray<long long>> local(threads);
+    for (int t = 0; t < threads; t++) {
+        local.Append(DynamicArray<long long>());
+    }
+    ParallelForBlocks(0, numNodes, [&](int blockBegin, int blockEnd, int worker) {
+        DynamicArray<long long>& counts = local[worker];
+        if (counts.GetLength() == 0) {
+            counts.Reserve(numNodes);
+            for (int v = 0; v < numNodes; v++) {
+                counts.Append(0);
+            }
+        }
+        const int* targets = oriented.targets.data();
+        for (int v = blockBegin; v < blockEnd; v++) {
+            const int* rowV = targets + oriented.offsets[v];
+            int lengthV = oriented.offsets[v + 1] - oriented.offsets[v];
+            for (int i = 0; i < lengthV; i++) {
+                int u = rowV[i];
+                long long found = 0;
+                TriangleDetail::Intersect(rowV, lengthV, targets + oriented.offsets[u],
+                    oriented.offsets[u + 1] - oriented.offsets[u], [&](int w) {
+                        counts[w]++;
+                        found++;
+                    });
+                counts[v] += found;
+                counts[u] += found;
+            }
+        }
+    });
+
+    TriangleStatistics result;
+    result.triangles = DynamicArray<long long>(numNodes);
+    result.clustering = DynamicArray<double>(numNodes);
+    long long sum = 0;
+    double clusteringSum = 0.0;
+    for (int v = 0; v < numNodes; v++) {
+        long long triangles = 0;
+        for (int t = 0; t < threads; t++) {
+            if (local[t].GetLength() > 0) triangles += local[t][v];
+        }
+        long long degree = full.offsets[v + 1] - full.offsets[v];
+        double clustering = degree < 2 ? 0.0 : 2.0 * triangles / (degree * (degree - 1));
+        result.triangles.Append(triangles);
+        result.clustering.Append(clustering);
+        sum += triangles;
+        clusteringSum += clustering;
+    }
+    result.totalTriangles = sum / 3;
+    result.averageClustering = numNodes > 0 ? clusteringSum / numNodes : 0.0;
+    return result;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "DynamicArray.h"
+#include <atomic>
+#include <stdexcept>
+
+// Sequential union-find with union by size and path compression
+class UnionFind {
+private:
+    DynamicArray<int> parent;
+    DynamicArray<int> setSize;
+
+public:
+    explicit UnionFind(int size) : parent(size), setSize(size) {
+        for (int i = 0; i < size; i++) {
+            parent.Append(i);
+            setSize.Append(1);
+        }
+    }
+
+    int GetSize() const {
+        return parent.GetLength();
+    }
+
+    int Find(int x) {
+        int root = x;
+        while (parent[root] != root) {
+            root = parent[root];
+        }
+        while (parent[x] != root) {
+            int next = parent[x];
+            parent[x] = root;
+            x = next;
+        }
+        return root;
+    }
+
+    // Returns false if a and b were already in the same set
+    bool Union(int a, int b) {
+        a = Find(a);
+        b = Find(b);
+        if (a == b)
+            return false;
+        if (setSize[a] < setSize[b]) {
+            int temp = a;
+            a = b;
+            b = temp;
+        }
+        parent[b] = a;
+        setSize[a] += setSize[b];
+        return true;
+    }
+
+    int GetSetSize(int x) {
+        return setSize[Find(x)];
+    }
+};
+
+// Union-find that can be used from several threads at once.
+// A root is always hooked under the smaller root, so parent[x] <= x and the
+// lock-free path halving in Find can never create a cycle.
+class ConcurrentUnionFind {
+private:
+    std::atomic<int>* parent;
+    int size;
+
+public:
+    explicit ConcurrentUnionFind(int size) : size(size) {
+        if (size < 0) throw std::out_of_range("ConcurrentUnionFind size is negative");
+        parent = new std::atomic<int>[size > 0 ? size : 1];
+        for (int i = 0; i < size; i++) {
+            parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentUnionFind(const ConcurrentUnionFind&) = delete;
+    ConcurrentUnionFind& operator=(const ConcurrentUnionFind&) = delete;
+
+    ~ConcurrentUnionFind() {
+        delete[] parent;
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    int Find(int x) {
+        while (true) {
+            int p = parent[x].load(std::memory_order_relaxed);
+            if (p == x)
+                return x;
+            int grandparent = parent[p].load(std::memory_order_relaxed);
+            if (grandparent != p) {
+                parent[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    // Returns false if a and b were already in the same set
+    bool Union(int a, int b) {
+        while (true) {
+            a = Find(a);
+            b = Find(b);
+            if (a == b)
+                return false;
+            if (a < b) {
+                int temp = a;
+                a = b;
+                b = temp;
+            }
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b))
+                return true;
+        }
+    }
+
+    // Points x directly at its root
+    void Compress(int x) {
+        parent[x].store(Find(x), std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include "CsrGraph.h"
+#include "Graph.h"
+#include <algorithm>
+
+// Vertex orders for cache locality. Every function returns the mapping newIndex: old id -> new id,
+// which can be applied with CsrGraph::Permute or Graph::Reorder. Directed graphs are ordered
+// by their underlying undirected graph.
+enum class VertexOrder {
+    Degree,
+    ReverseCuthillMcKee,
+    BreadthFirst,
+    Community
+};
+
+namespace OrderingDetail {
+
+    template <typename TKey, typename WeightPolicy, typename Visit>
+    void ForEachNeighbor(const CsrGraph<TKey, WeightPolicy>& graph, int v, Visit visit)
+    {
+        for (int e = graph.RowBegin(v); e < graph.RowEnd(v); e++) {
+            visit(graph.GetTarget(e));
+        }
+        if (graph.IsDirected()) {
+            for (int e = graph.InRowBegin(v); e < graph.InRowEnd(v); e++) {
+                visit(graph.GetSource(e));
+            }
+        }
+    }
+
+    template <typename TKey, typename WeightPolicy>
+    int TotalDegree(const CsrGraph<TKey, WeightPolicy>& graph, int v)
+    {
+        return graph.GetDegree(v) + (graph.IsDirected() ? graph.GetInDegree(v) : 0);
+    }
+
+    // newIndex of the vertices listed in visiting order
+    inline DynamicArray<int> RanksOf(const DynamicArray<int>& order)
+    {
+        DynamicArray<int> newIndex(order.GetLength());
+        for (int i = 0; i < order.GetLength(); i++) {
+            newIndex.Append(0);
+        }
+        for (int i = 0; i < order.GetLength(); i++) {
+            newIndex[order[i]] = i;
+        }
+        return newIndex;
+    }
+
+    // Vertices sorted by key with counting sort; ties keep the order of the input list
+    inline DynamicArray<int> SortByKey(const DynamicArray<int>& vertices, const DynamicArray<int>& key, int maxKey)
+    {
+        DynamicArray<int> start(maxKey + 2);
+        for (int k = 0; k < maxKey + 2; k++) {
+            start.Append(0);
+        }
+        for (int i = 0; i < vertices.GetLength(); i++) {
+            start[key[vertices[i]] + 1]++;
+        }
+        for (int k = 0; k <= maxKey; k++) {
+            start[k + 1] += start[k];
+        }
+        DynamicArray<int> sorted(vertices.GetLength());
+        for (int i = 0; i < vertices.GetLength(); i++) {
+            sorted.Append(0);
+        }
+        for (int i = 0; i < vertices.GetLength(); i++) {
+            sorted[start[key[vertices[i]]]++] = vertices[i];
+        }
+        return sorted;
+    }
+
+    // Breadth-first visiting order of all components; every component starts at the first
+    // unvisited vertex of starts and neighbors are queued by increasing degree if byDegree is set
+    template <typename TKey, typename WeightPolicy>
+    DynamicArray<int> BreadthFirstVisit(const CsrGraph<TKey, WeightPolicy>& graph, const DynamicArray<int>& starts,
+        bool byDegree)
+    {
+        int numNodes = graph.GetNodeCount();
+        DynamicArray<bool> visited(numNodes);
+        for (int v = 0; v < numNodes; v++) {
+            visited.Append(false);
+        }
+        DynamicArray<int> order(numNodes);
+        DynamicArray<int> neighbors;
+        for (int s = 0; s < starts.GetLength(); s++) {
+            if (visited[starts[s]])
+                continue;
+            visited[starts[s]] = true;
+            order.Append(starts[s]);
+            for (int head = order.GetLength() - 1; head < order.GetLength(); head++) {
+                neighbors.Truncate(0);
+                ForEachNeighbor(graph, order[head], [&](int w) {
+                    if (!visited[w]) {
+                        visited[w] = true;
+                        neighbors.Append(w);
+                    }
+                });
+                if (byDegree && neighbors.GetLength() > 1) {
+                    std::stable_sort(neighbors.begin(), neighbors.end(), [&graph](int a, int b) {
+                        return TotalDegree(graph, a) < TotalDegree(graph, b);
+                    });
+                }
+                for (int i = 0; i < neighbors.GetLength(); i++) {
+                    order.Append(neighbors[i]);
+                }
+            }
+        }
+        return order;
+    }
+
+    inline DynamicArray<int> Identity(int size)
+    {
+        DynamicArray<int> vertices(size);
+        for (int v = 0; v < size; v++) {
+            vertices.Append(v);
+        }
+        return vertices;
+    }
+
+}
+
+// Highest degree first, so the hubs share the first cache lines
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> DegreeOrder(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> key(numNodes);
+    int maxDegree = 0;
+    for (int v = 0; v < numNodes; v++) {
+        int degree = OrderingDetail::TotalDegree(graph, v);
+        key.Append(degree);
+        if (degree > maxDegree) maxDegree = degree;
+    }
+    for (int v = 0; v < numNodes; v++) {
+        key[v] = maxDegree - key[v];
+    }
+    return OrderingDetail::RanksOf(OrderingDetail::SortByKey(OrderingDetail::Identity(numNodes), key, maxDegree));
+}
+
+// Breadth-first order from vertex 0, then from the first vertex of every unvisited component
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> BreadthFirstOrder(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    DynamicArray<int> starts = OrderingDetail::Identity(graph.GetNodeCount());
+    return OrderingDetail::RanksOf(OrderingDetail::BreadthFirstVisit(graph, starts, false));
+}
+
+// Reverse Cuthill-McKee: breadth-first from a low-degree vertex of every component with neighbors
+// queued by increasing degree, reversed. Keeps the bandwidth of the adjacency matrix small.
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> ReverseCuthillMcKeeOrder(const CsrGraph<TKey, WeightPolicy>& graph)
+{
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> degree(numNodes);
+    int maxDegree = 0;
+    for (int v = 0; v < numNodes; v++) {
+        degree.Append(OrderingDetail::TotalDegree(graph, v));
+        if (degree[v] > maxDegree) maxDegree = degree[v];
+    }
+    DynamicArray<int> starts = OrderingDetail::SortByKey(OrderingDetail::Identity(numNodes), degree, maxDegree);
+    DynamicArray<int> order = OrderingDetail::BreadthFirstVisit(graph, starts, true);
+    DynamicArray<int> newIndex = OrderingDetail::RanksOf(order);
+    for (int v = 0; v < numNodes; v++) {
+        newIndex[v] = numNodes - 1 - newIndex[v];
+    }
+    return newIndex;
+}
+
+// Communities found by label propagation are laid out one after another, each in breadth-first
+// order, so that most edges stay inside a contiguous block of ids
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> CommunityOrder(const CsrGraph<TKey, WeightPolicy>& graph, int rounds = 5)
+{
+    int numNodes = graph.GetNodeCount();
+    DynamicArray<int> label = OrderingDetail::Identity(numNodes);
+    DynamicArray<int> neighborLabels;
+    for (int r = 0; r < rounds; r++) {
+        bool changed = false;
+        for (int v = 0; v < numNodes; v++) {
+            neighborLabels.Truncate(0);
+            OrderingDetail::ForEachNeighbor(graph, v, [&](int w) { neighborLabels.Append(label[w]); });
+            if (neighborLabels.GetLength() == 0)
+                continue;
+            std::sort(neighborLabels.begin(), neighborLabels.end());
+            // most frequent neighbor label, the smallest one on ties
+            int best = neighborLabels[0];
+            int bestCount = 0;
+            for (int i = 0; i < neighborLabels.GetLength();) {
+                int j = i;
+                while (j < neighborLabels.GetLength() && neighborLabels[j] == neighborLabels[i]) j++;
+                if (j - i > bestCount) {
+                    bestCount = j - i;
+                    best = neighborLabels[i];
+                }
+                i = j;
+            }
+            if (best != label[v]) {
+                label[v] = best;
+                changed = true;
+            }
+        }
+        if (!changed)
+            break;
+    }
+
+    // communities are numbered in the order their first vertex is met by the breadth-first visit
+    DynamicArray<int> visit = OrderingDetail::BreadthFirstVisit(graph, OrderingDetail::Identity(numNodes), false);
+    DynamicArray<int> community(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        community.Append(-1);
+    }
+    int communities = 0;
+    for (int i = 0; i < numNodes; i++) {
+        int l = label[visit[i]];
+        if (community[l] == -1) community[l] = communities++;
+    }
+    DynamicArray<int> key(numNodes);
+    for (int v = 0; v < numNodes; v++) {
+        key.Append(community[label[v]]);
+    }
+    return OrderingDetail::RanksOf(OrderingDetail::SortByKey(visit, key, communities > 0 ? communities - 1 : 0));
+}
+
+template <typename TKey, typename WeightPolicy>
+DynamicArray<int> ComputeVertexOrder(const CsrGraph<TKey, WeightPolicy>& graph, VertexOrder order)
+{
+    switch (order) {
+    case VertexOrder::Degree:
+        return DegreeOrder(graph);
+    case VertexOrder::ReverseCuthillMcKee:
+        return ReverseCuthillMcKeeOrder(graph);
+    case VertexOrder::BreadthFirst:
+        return BreadthFirstOrder(graph);
+    default:
+        return CommunityOrder(graph);
+    }
+}
+
+// Renumbers the vertices of a Graph in place; returns the mapping old index -> new index
+template <typename TKey, typename WeightType, typename Direction>
+DynamicArray<int> ReorderVertices(Graph<TKey, WeightType, Direction>& graph, VertexOrder order)
+{
+    DynamicArray<int> newIndex = ComputeVertexOrder(CsrGraph<TKey, ExactWeights<WeightType>>(graph), order);
+    graph.Reorder(newIndex);
+    return newIndex;
+}